@@ -0,0 +1,463 @@
+// Benchmarks the SparseSet hot paths against std::unordered_map and a sorted flat map.
+// Self-contained, only needs a C++20 compiler (-DAZERO_SPARSE_SET_PARALLEL_STL=1 runs the parallel Build on std::execution::par, which with libstdc++ also needs -ltbb):
+//	g++ -std=c++20 -O2 -DNDEBUG -I include bench/SparseSetBenchmark.cpp -o SparseSetBenchmark
+//	cl /std:c++20 /O2 /DNDEBUG /EHsc /I include bench\SparseSetBenchmark.cpp
+// Usage: SparseSetBenchmark [numElements] [filter]
+// Only rows whose label contains filter are run, e.g. "u32/64B/scattered/cold".
+#include "SparseSet.hpp"
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	volatile std::uint64_t g_Sink = 0;
+
+	// Keeps results observable so the measured loops aren't optimized away.
+	void Consume(std::uint64_t value)
+	{
+		g_Sink = g_Sink + value;
+	}
+
+	template<std::size_t Bytes>
+	struct Payload
+	{
+		std::uint32_t Value;
+		std::byte Padding[Bytes - sizeof(std::uint32_t)];
+	};
+
+	template<>
+	struct Payload<sizeof(std::uint32_t)>
+	{
+		std::uint32_t Value;
+	};
+
+	template<std::size_t Bytes>
+	[[nodiscard]] Payload<Bytes> MakePayload(std::uint32_t value)
+	{
+		Payload<Bytes> payload{};
+		payload.Value = value;
+		return payload;
+	}
+
+	// Touching a buffer larger than the last level cache evicts the containers between repetitions.
+	void EvictCaches()
+	{
+		static std::vector<std::uint64_t> buffer(std::size_t(64) << 17);
+		std::uint64_t sum = 0;
+		for (std::uint64_t& value : buffer)
+		{
+			value++;
+			sum += value;
+		}
+		Consume(sum);
+	}
+
+	template<typename IDType, typename ElementType, typename Config>
+	class SparseSetAdapter
+	{
+	public:
+		void Insert(IDType id, const ElementType& element) { m_Set.Insert(id, element); }
+		void Finalize() { }
+		[[nodiscard]] bool Exists(IDType id) const { return m_Set.Exists(id); }
+		[[nodiscard]] const ElementType& Get(IDType id) const { return m_Set.Get(id); }
+
+		[[nodiscard]] const ElementType* GetIfExists(IDType id) const
+		{
+			auto found = m_Set.GetIfExists(id);
+			return found ? &found->get() : nullptr;
+		}
+
+		void Erase(IDType id) { m_Set.Erase(id); }
+		void FinishErase() { }
+
+		template<typename Func>
+		void ForEach(Func&& func) const
+		{
+			for (const ElementType& element : m_Set)
+			{
+				func(element);
+			}
+		}
+
+	private:
+		aZero::DS::SparseSet<IDType, ElementType, Config> m_Set;
+	};
+
+	template<typename IDType, typename ElementType>
+	class UnorderedMapAdapter
+	{
+	public:
+		void Insert(IDType id, const ElementType& element) { m_Map.emplace(id, element); }
+		void Finalize() { }
+		[[nodiscard]] bool Exists(IDType id) const { return m_Map.find(id) != m_Map.end(); }
+		[[nodiscard]] const ElementType& Get(IDType id) const { return m_Map.at(id); }
+
+		[[nodiscard]] const ElementType* GetIfExists(IDType id) const
+		{
+			const auto found = m_Map.find(id);
+			return found != m_Map.end() ? &found->second : nullptr;
+		}
+
+		void Erase(IDType id) { m_Map.erase(id); }
+		void FinishErase() { }
+
+		template<typename Func>
+		void ForEach(Func&& func) const
+		{
+			for (const auto& entry : m_Map)
+			{
+				func(entry.second);
+			}
+		}
+
+	private:
+		std::unordered_map<IDType, ElementType> m_Map;
+	};
+
+	// Sorted vector of (id, element). Per-element sorted insertion and erasure are quadratic, so inserts append and Finalize() sorts once,
+	// and erases mark entries that FinishErase() compacts in one pass.
+	template<typename IDType, typename ElementType>
+	class FlatMapAdapter
+	{
+		using Entry = std::pair<IDType, ElementType>;
+
+	public:
+		void Insert(IDType id, const ElementType& element) { m_Entries.emplace_back(id, element); }
+
+		void Finalize()
+		{
+			std::sort(m_Entries.begin(), m_Entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.first < rhs.first; });
+			m_Entries.erase(std::unique(m_Entries.begin(), m_Entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.first == rhs.first; }), m_Entries.end());
+			m_Erased.assign(m_Entries.size(), false);
+		}
+
+		[[nodiscard]] bool Exists(IDType id) const { return this->Find(id) != m_Entries.end(); }
+		[[nodiscard]] const ElementType& Get(IDType id) const { return this->Find(id)->second; }
+
+		[[nodiscard]] const ElementType* GetIfExists(IDType id) const
+		{
+			const auto found = this->Find(id);
+			return found != m_Entries.end() ? &found->second : nullptr;
+		}
+
+		void Erase(IDType id)
+		{
+			const auto found = this->Find(id);
+			if (found != m_Entries.end())
+			{
+				m_Erased[static_cast<std::size_t>(found - m_Entries.begin())] = true;
+			}
+		}
+
+		void FinishErase()
+		{
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < m_Entries.size(); i++)
+			{
+				if (!m_Erased[i])
+				{
+					m_Entries[kept++] = m_Entries[i];
+				}
+			}
+			m_Entries.resize(kept);
+			m_Erased.assign(kept, false);
+		}
+
+		template<typename Func>
+		void ForEach(Func&& func) const
+		{
+			for (const Entry& entry : m_Entries)
+			{
+				func(entry.second);
+			}
+		}
+
+	private:
+		[[nodiscard]] typename std::vector<Entry>::const_iterator Find(IDType id) const
+		{
+			const auto found = std::lower_bound(m_Entries.begin(), m_Entries.end(), id, [](const Entry& entry, IDType value) { return entry.first < value; });
+			return found != m_Entries.end() && found->first == id ? found : m_Entries.end();
+		}
+
+		std::vector<Entry> m_Entries;
+		std::vector<bool> m_Erased;
+	};
+
+	enum class Distribution { Dense, Scattered };
+	enum class Cache { Hot, Cold };
+
+	struct Settings
+	{
+		std::size_t NumElements = 1 << 16;
+		std::string Filter;
+		int Repetitions = 3;
+	};
+
+	template<typename IDType>
+	[[nodiscard]] std::vector<IDType> MakeIDs(std::size_t count, Distribution distribution, std::mt19937_64& random)
+	{
+		const std::uint64_t maxID = std::numeric_limits<IDType>::max() - 1;
+		count = static_cast<std::size_t>(std::min<std::uint64_t>(count, maxID + 1));
+
+		std::vector<IDType> ids;
+		ids.reserve(count);
+		if (distribution == Distribution::Dense || count > maxID / 2)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				ids.push_back(static_cast<IDType>(i));
+			}
+		}
+		else
+		{
+			// Scattered IDs are spread over up to 2^24 so the flat sparse index stays within a sane size.
+			const std::uint64_t range = std::min<std::uint64_t>(maxID, std::max<std::uint64_t>(std::uint64_t(1) << 24, count * 2));
+			std::uniform_int_distribution<std::uint64_t> pick(0, range);
+			std::unordered_set<std::uint64_t> used;
+			while (ids.size() < count)
+			{
+				const std::uint64_t id = pick(random);
+				if (used.insert(id).second)
+				{
+					ids.push_back(static_cast<IDType>(id));
+				}
+			}
+		}
+		std::shuffle(ids.begin(), ids.end(), random);
+		return ids;
+	}
+
+	template<typename Setup, typename Body>
+	[[nodiscard]] double Measure(const Settings& settings, Cache cache, std::size_t numOps, Setup&& setup, Body&& body)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int repetition = 0; repetition < settings.Repetitions; repetition++)
+		{
+			auto state = setup();
+			if (cache == Cache::Cold)
+			{
+				EvictCaches();
+			}
+			const Clock::time_point start = Clock::now();
+			body(state);
+			const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+			best = std::min(best, elapsed.count() / static_cast<double>(std::max<std::size_t>(numOps, 1)));
+		}
+		return best;
+	}
+
+	template<typename Container, typename IDType, typename ElementType>
+	void RunContainer(const Settings& settings, const std::string& label, Cache cache, const std::vector<IDType>& ids, const std::vector<IDType>& lookups)
+	{
+		if (!settings.Filter.empty() && label.find(settings.Filter) == std::string::npos)
+			return;
+
+		auto fill = [&]()
+			{
+				Container container;
+				for (const IDType id : ids)
+				{
+					container.Insert(id, MakePayload<sizeof(ElementType)>(static_cast<std::uint32_t>(id)));
+				}
+				container.Finalize();
+				return container;
+			};
+
+		const double insert = Measure(settings, cache, ids.size(), [] { return Container(); }, [&](Container& container)
+			{
+				for (const IDType id : ids)
+				{
+					container.Insert(id, MakePayload<sizeof(ElementType)>(static_cast<std::uint32_t>(id)));
+				}
+				container.Finalize();
+			});
+
+		const double exists = Measure(settings, cache, lookups.size(), fill, [&](Container& container)
+			{
+				std::uint64_t found = 0;
+				for (const IDType id : lookups)
+				{
+					found += container.Exists(id);
+				}
+				Consume(found);
+			});
+
+		const double get = Measure(settings, cache, ids.size(), fill, [&](Container& container)
+			{
+				std::uint64_t sum = 0;
+				for (const IDType id : ids)
+				{
+					sum += container.Get(id).Value;
+				}
+				Consume(sum);
+			});
+
+		const double getIfExists = Measure(settings, cache, lookups.size(), fill, [&](Container& container)
+			{
+				std::uint64_t sum = 0;
+				for (const IDType id : lookups)
+				{
+					if (const ElementType* element = container.GetIfExists(id))
+					{
+						sum += element->Value;
+					}
+				}
+				Consume(sum);
+			});
+
+		const double iterate = Measure(settings, cache, ids.size(), fill, [&](Container& container)
+			{
+				std::uint64_t sum = 0;
+				container.ForEach([&sum](const ElementType& element) { sum += element.Value; });
+				Consume(sum);
+			});
+
+		const double erase = Measure(settings, cache, ids.size(), fill, [&](Container& container)
+			{
+				for (const IDType id : ids)
+				{
+					container.Erase(id);
+				}
+				container.FinishErase();
+			});
+
+		std::printf("%-48s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", label.c_str(), insert, exists, get, getIfExists, iterate, erase);
+	}
+
+	struct PagedConfig : aZero::DS::DefaultSparseSetConfig
+	{
+		static constexpr std::size_t SparsePageSize = 4096;
+	};
+
+	template<typename IDType, std::size_t Bytes>
+	void RunCase(const Settings& settings, const char* idName, Distribution distribution, Cache cache)
+	{
+		using ElementType = Payload<Bytes>;
+
+		std::mt19937_64 random(0x5eed);
+		const std::vector<IDType> ids = MakeIDs<IDType>(settings.NumElements, distribution, random);
+
+		// Half of the lookups hit, the other half ask for IDs the set doesn't hold (unless the ID width has none left).
+		std::vector<IDType> lookups(ids.begin(), ids.begin() + ids.size() / 2);
+		const std::unordered_set<IDType> present(ids.begin(), ids.end());
+		const std::uint64_t maxMiss = std::min<std::uint64_t>(std::numeric_limits<IDType>::max() - 1, std::max<std::uint64_t>(std::uint64_t(1) << 24, ids.size() * 2));
+		std::uniform_int_distribution<std::uint64_t> pickMiss(0, maxMiss);
+		for (std::size_t attempt = 0; lookups.size() < ids.size() && attempt < ids.size() * 8; attempt++)
+		{
+			const IDType id = static_cast<IDType>(pickMiss(random));
+			if (!present.contains(id))
+			{
+				lookups.push_back(id);
+			}
+		}
+		std::shuffle(lookups.begin(), lookups.end(), random);
+
+		const std::string suffix = std::string("/") + idName + "/" + std::to_string(Bytes) + "B/" + (distribution == Distribution::Dense ? "dense" : "scattered") + "/" + (cache == Cache::Hot ? "hot" : "cold");
+
+		RunContainer<SparseSetAdapter<IDType, ElementType, aZero::DS::DefaultSparseSetConfig>, IDType, ElementType>(settings, "SparseSet" + suffix, cache, ids, lookups);
+		RunContainer<SparseSetAdapter<IDType, ElementType, aZero::DS::UncheckedSparseSetConfig>, IDType, ElementType>(settings, "SparseSet(unchecked)" + suffix, cache, ids, lookups);
+		RunContainer<SparseSetAdapter<IDType, ElementType, PagedConfig>, IDType, ElementType>(settings, "SparseSet(paged)" + suffix, cache, ids, lookups);
+		RunContainer<UnorderedMapAdapter<IDType, ElementType>, IDType, ElementType>(settings, "unordered_map" + suffix, cache, ids, lookups);
+		RunContainer<FlatMapAdapter<IDType, ElementType>, IDType, ElementType>(settings, "flat_map" + suffix, cache, ids, lookups);
+	}
+
+	// Construction from shuffled unique IDs: one Insert per pair, one InsertBatch and SparseSet::Build on the default executor.
+	// Build trails InsertBatch with a single hardware thread, its parallel passes only pay off on several cores.
+	template<typename IDType, std::size_t Bytes>
+	void RunBuild(const Settings& settings, const char* idName, Distribution distribution)
+	{
+		using ElementType = Payload<Bytes>;
+		using Set = aZero::DS::SparseSet<IDType, ElementType>;
+
+		const std::string label = std::string("Build/") + idName + "/" + std::to_string(Bytes) + "B/" + (distribution == Distribution::Dense ? "dense" : "scattered");
+		if (!settings.Filter.empty() && label.find(settings.Filter) == std::string::npos)
+			return;
+
+		std::mt19937_64 random(0x5eed);
+		const std::vector<IDType> ids = MakeIDs<IDType>(settings.NumElements, distribution, random);
+		std::vector<ElementType> elements;
+		elements.reserve(ids.size());
+		for (const IDType id : ids)
+		{
+			elements.push_back(MakePayload<Bytes>(static_cast<std::uint32_t>(id)));
+		}
+
+		auto empty = [] { return std::optional<Set>(std::in_place); };
+
+		const double insert = Measure(settings, Cache::Hot, ids.size(), empty, [&](std::optional<Set>& set)
+			{
+				for (std::size_t i = 0; i < ids.size(); i++)
+				{
+					set->Insert(ids[i], elements[i]);
+				}
+				Consume(set->Size());
+			});
+
+		const double batch = Measure(settings, Cache::Hot, ids.size(), empty, [&](std::optional<Set>& set)
+			{
+				Consume(set->InsertBatch(ids, elements));
+			});
+
+		const double build = Measure(settings, Cache::Hot, ids.size(), [] { return std::optional<Set>(); }, [&](std::optional<Set>& set)
+			{
+				set.emplace(Set::Build(ids, elements));
+				Consume(set->Size());
+			});
+
+		std::printf("%-48s %10.2f %10.2f %10.2f\n", label.c_str(), insert, batch, build);
+	}
+
+	template<typename IDType>
+	void RunWidth(const Settings& settings, const char* idName)
+	{
+		for (const Distribution distribution : { Distribution::Dense, Distribution::Scattered })
+		{
+			for (const Cache cache : { Cache::Hot, Cache::Cold })
+			{
+				RunCase<IDType, 4>(settings, idName, distribution, cache);
+				RunCase<IDType, 16>(settings, idName, distribution, cache);
+				RunCase<IDType, 64>(settings, idName, distribution, cache);
+				RunCase<IDType, 256>(settings, idName, distribution, cache);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Settings settings;
+	if (argc > 1)
+	{
+		settings.NumElements = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+	}
+	if (argc > 2)
+	{
+		settings.Filter = argv[2];
+	}
+
+	std::printf("ns per operation, best of %d, %zu elements (capped by the ID width)\n", settings.Repetitions, settings.NumElements);
+	std::printf("%-48s %10s %10s %10s %10s %10s %10s\n", "container/id/element/ids/cache", "Insert", "Exists", "Get", "GetIfExist", "Iterate", "Erase");
+
+	RunWidth<std::uint8_t>(settings, "u8");
+	RunWidth<std::uint16_t>(settings, "u16");
+	RunWidth<std::uint32_t>(settings, "u32");
+	RunWidth<std::uint64_t>(settings, "u64");
+
+	std::printf("\n%-48s %10s %10s %10s\n", "build/id/element/ids", "Insert", "InsertBatch", "Build");
+	for (const Distribution distribution : { Distribution::Dense, Distribution::Scattered })
+	{
+		RunBuild<std::uint32_t, 16>(settings, "u32", distribution);
+		RunBuild<std::uint32_t, 64>(settings, "u32", distribution);
+		RunBuild<std::uint64_t, 16>(settings, "u64", distribution);
+		RunBuild<std::uint64_t, 64>(settings, "u64", distribution);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+#include "SparseSet.hpp"
+
+namespace aZero
+{
+	namespace DS
+	{
+		// Records Insert and Erase calls for a SparseSet and applies them later with Flush(), at a point where nothing else touches the set.
+		// A buffer belongs to one thread, recording doesn't lock or touch the set. Give every worker its own buffer and flush them one after another.
+		// Flush keeps the outcome of applying the commands in order but merges the commands of each ID first:
+		// an Erase drops every earlier command of its ID, and only the first Insert after the last Erase is kept since later ones would be ignored.
+		// With versioned IDs an Insert evicts the other versions of its index, so the commands of an index are replayed in order instead
+		// when they mix versions or end with an Erase after an Insert, which the merged Erase alone couldn't reproduce.
+		template<typename Set>
+		class CommandBuffer
+		{
+		public:
+			using IDType = typename Set::KeyType;
+			using ElementType = typename Set::ValueType;
+			using AllocatorType = typename Set::AllocatorType;
+			using IDTraits = typename Set::IDTraits;
+
+			CommandBuffer() = default;
+
+			explicit CommandBuffer(const AllocatorType& allocator)
+				:m_Commands(allocator), m_Elements(allocator), m_EraseIDs(allocator), m_InsertIDs(allocator), m_InsertElements(allocator){ }
+
+			void Insert(IDType id, const ElementType& element)
+			{
+				m_Commands.push_back({ id, static_cast<std::uint32_t>(m_Commands.size()), static_cast<std::uint32_t>(m_Elements.size()) });
+				m_Elements.push_back(element);
+			}
+
+			void Erase(IDType id)
+			{
+				m_Commands.push_back({ id, static_cast<std::uint32_t>(m_Commands.size()), NoElement });
+			}
+
+			[[nodiscard]] std::size_t Size() const { return m_Commands.size(); }
+
+			[[nodiscard]] bool Empty() const { return m_Commands.empty(); }
+
+			void Clear()
+			{
+				m_Commands.clear();
+				m_Elements.clear();
+			}
+
+			// Applies the merged commands to set with one EraseBatch and one InsertBatch and clears the buffer.
+			// An ID that is erased and then inserted again ends up holding the new element, like it would when applied in order.
+			// Indices that can't be merged with versioned IDs are replayed with Insert and Erase after the batches.
+			void Flush(Set& set)
+			{
+				if (m_Commands.empty())
+					return;
+
+				std::sort(m_Commands.begin(), m_Commands.end(), [](const Command& lhs, const Command& rhs)
+					{
+						const IDType lhsIndex = IDTraits::IndexOf(lhs.ID);
+						const IDType rhsIndex = IDTraits::IndexOf(rhs.ID);
+						return lhsIndex != rhsIndex ? lhsIndex < rhsIndex : lhs.Sequence < rhs.Sequence;
+					});
+
+				m_EraseIDs.clear();
+				m_InsertIDs.clear();
+				m_InsertElements.clear();
+				bool replays = false;
+				for (std::size_t first = 0; first < m_Commands.size();)
+				{
+					const std::size_t last = this->GroupEnd(first);
+					if (!this->Mergeable(first, last))
+					{
+						replays = true;
+						first = last;
+						continue;
+					}
+
+					bool erases = false;
+					std::uint32_t insertElement = NoElement;
+					for (std::size_t i = first; i < last; i++)
+					{
+						if (m_Commands[i].Element == NoElement)
+						{
+							erases = true;
+							insertElement = NoElement;
+						}
+						else if (insertElement == NoElement)
+						{
+							insertElement = m_Commands[i].Element;
+						}
+					}
+
+					if (erases)
+					{
+						m_EraseIDs.push_back(m_Commands[first].ID);
+					}
+					if (insertElement != NoElement)
+					{
+						m_InsertIDs.push_back(m_Commands[first].ID);
+						m_InsertElements.push_back(m_Elements[insertElement]);
+					}
+					first = last;
+				}
+
+				set.EraseBatch(m_EraseIDs);
+				set.InsertBatch(m_InsertIDs, m_InsertElements);
+
+				// Indices are independent of each other, so the replayed groups can follow the batches
+				for (std::size_t first = 0; replays && first < m_Commands.size();)
+				{
+					const std::size_t last = this->GroupEnd(first);
+					if (!this->Mergeable(first, last))
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							if (m_Commands[i].Element == NoElement)
+							{
+								set.Erase(m_Commands[i].ID);
+							}
+							else
+							{
+								set.Insert(m_Commands[i].ID, m_Elements[m_Commands[i].Element]);
+							}
+						}
+					}
+					first = last;
+				}
+				this->Clear();
+			}
+
+		private:
+			static constexpr std::uint32_t NoElement = std::numeric_limits<std::uint32_t>::max();
+
+			// End of the sorted commands that share the index of m_Commands[first]
+			[[nodiscard]] std::size_t GroupEnd(std::size_t first) const
+			{
+				const IDType index = IDTraits::IndexOf(m_Commands[first].ID);
+				std::size_t last = first + 1;
+				while (last < m_Commands.size() && IDTraits::IndexOf(m_Commands[last].ID) == index)
+					last++;
+				return last;
+			}
+
+			[[nodiscard]] bool Mergeable(std::size_t first, std::size_t last) const
+			{
+				if constexpr (IDTraits::MaxVersion == 0)
+				{
+					return true;
+				}
+				else
+				{
+					bool inserts = false;
+					for (std::size_t i = first; i < last; i++)
+					{
+						if (m_Commands[i].ID != m_Commands[first].ID)
+							return false;
+						inserts = inserts || m_Commands[i].Element != NoElement;
+					}
+					return !inserts || m_Commands[last - 1].Element != NoElement;
+				}
+			}
+
+			struct Command
+			{
+				IDType ID;
+				std::uint32_t Sequence;
+				std::uint32_t Element;
+			};
+
+			template<typename T>
+			using Vector = std::vector<T, detail::RebindAllocator<AllocatorType, T>>;
+
+			Vector<Command> m_Commands;
+			Vector<ElementType> m_Elements;
+			Vector<IDType> m_EraseIDs;
+			Vector<IDType> m_InsertIDs;
+			Vector<ElementType> m_InsertElements;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <atomic>
+#include <array>
+
+namespace aZero
+{
+	namespace DS
+	{
+		// True for stats policies whose hooks may run on several threads at once against one set, since readers look up a shared snapshot.
+		// Specialize it for a custom policy that synchronizes its counters.
+		template<typename Stats>
+		struct IsConcurrentStats : std::false_type { };
+
+		template<>
+		struct IsConcurrentStats<NoStats> : std::true_type { };
+
+		template<>
+		struct IsConcurrentStats<ThreadCountingStats> : std::true_type { };
+
+		// A SparseSet with one writer thread and any number of lock-free readers.
+		// The writer mutates a private set and calls Publish() to hand an immutable copy of it to readers.
+		// A reader pins the current epoch in one of MaxReaders slots and reads the snapshot that was published at that time, it never waits for the writer.
+		// Replaced snapshots are reclaimed by the writer once no pinned epoch can still reference them.
+		template<UnsignedInteger IDType, IsTriviallyCopyable ElementType, typename Config = DefaultSparseSetConfig, std::size_t MaxReaders = 64>
+		class ConcurrentSparseSet
+		{
+			static_assert(IsConcurrentStats<typename Config::Stats>::value, "ConcurrentSparseSet readers share a snapshot, Config::Stats has to be safe for concurrent lookups such as NoStats or ThreadCountingStats");
+
+		public:
+			using SetType = SparseSet<IDType, ElementType, Config>;
+			using KeyType = IDType;
+			using ValueType = ElementType;
+
+		private:
+			static constexpr std::uint64_t Unpinned = 0;
+
+			struct alignas(detail::CacheLineSize) ReaderSlot
+			{
+				std::atomic<std::uint64_t> Epoch{ Unpinned };
+			};
+
+			struct Retired
+			{
+				const SetType* Snapshot;
+				std::uint64_t Epoch;
+			};
+
+		public:
+			// Keeps one snapshot alive while it is held. Only valid while the ConcurrentSparseSet exists.
+			class ReadGuard
+			{
+			public:
+				ReadGuard(const ReadGuard&) = delete;
+				ReadGuard& operator=(const ReadGuard&) = delete;
+
+				ReadGuard(ReadGuard&& other) noexcept
+					:m_Slot(std::exchange(other.m_Slot, nullptr)), m_Snapshot(std::exchange(other.m_Snapshot, nullptr)){ }
+
+				ReadGuard& operator=(ReadGuard&& other) noexcept
+				{
+					if (this != &other)
+					{
+						this->Release();
+						m_Slot = std::exchange(other.m_Slot, nullptr);
+						m_Snapshot = std::exchange(other.m_Snapshot, nullptr);
+					}
+					return *this;
+				}
+
+				~ReadGuard() { this->Release(); }
+
+				[[nodiscard]] const SetType& operator*() const { return *m_Snapshot; }
+				[[nodiscard]] const SetType* operator->() const { return m_Snapshot; }
+
+			private:
+				friend class ConcurrentSparseSet;
+
+				ReadGuard(ReaderSlot* slot, const SetType* snapshot)
+					:m_Slot(slot), m_Snapshot(snapshot){ }
+
+				void Release()
+				{
+					if (m_Slot)
+					{
+						m_Slot->Epoch.store(Unpinned, std::memory_order_release);
+						m_Slot = nullptr;
+					}
+				}
+
+				ReaderSlot* m_Slot;
+				const SetType* m_Snapshot;
+			};
+
+			ConcurrentSparseSet()
+				:m_Published(new SetType()), m_Epoch(1){ }
+
+			ConcurrentSparseSet(const ConcurrentSparseSet&) = delete;
+			ConcurrentSparseSet& operator=(const ConcurrentSparseSet&) = delete;
+
+			// No ReadGuard may outlive the set.
+			~ConcurrentSparseSet()
+			{
+				delete m_Published.load(std::memory_order_relaxed);
+				for (const Retired& retired : m_Retired)
+				{
+					delete retired.Snapshot;
+				}
+			}
+
+			// Pins the current snapshot. Spins while all MaxReaders slots are pinned by other readers.
+			// Each thread starts probing at its own slot, so concurrent readers don't all contend on the first cache lines.
+			[[nodiscard]] ReadGuard Read() const
+			{
+				const std::size_t first = FirstSlot();
+				for (;;)
+				{
+					for (std::size_t i = 0; i < MaxReaders; i++)
+					{
+						ReaderSlot& slot = m_Readers[(first + i) % MaxReaders];
+						std::uint64_t expected = Unpinned;
+						const std::uint64_t epoch = m_Epoch.load(std::memory_order_seq_cst);
+						if (slot.Epoch.load(std::memory_order_relaxed) == Unpinned && slot.Epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst))
+						{
+							return ReadGuard(&slot, m_Published.load(std::memory_order_seq_cst));
+						}
+					}
+					std::this_thread::yield();
+				}
+			}
+
+			// Single lookups against the latest snapshot, each pins and releases a slot.
+			[[nodiscard]] bool Exists(IDType id) const
+			{
+				return this->Read()->Exists(id);
+			}
+
+			[[nodiscard]] std::optional<ElementType> TryGet(IDType id) const
+			{
+				const ReadGuard guard = this->Read();
+				const auto found = guard->GetIfExists(id);
+				return found ? std::optional<ElementType>(found->get()) : std::nullopt;
+			}
+
+			// The writer's private set. Only the writer thread may use it, changes become visible to readers on Publish().
+			[[nodiscard]] SetType& Writer() { return m_Writer; }
+
+			[[nodiscard]] const SetType& Writer() const { return m_Writer; }
+
+			bool Insert(IDType id, const ElementType& element) { return m_Writer.Insert(id, element); }
+
+			bool Erase(IDType id) { return m_Writer.Erase(id); }
+
+			// Copies the writer's set into a new snapshot, makes it the one new readers see and reclaims the snapshots no reader can reach anymore.
+			void Publish()
+			{
+				const SetType* previous = m_Published.exchange(new SetType(m_Writer), std::memory_order_seq_cst);
+				m_Retired.push_back({ previous, m_Epoch.fetch_add(1, std::memory_order_seq_cst) });
+				this->Reclaim();
+			}
+
+			// Frees the retired snapshots that every pinned reader started after. Publish() already calls this.
+			void Reclaim()
+			{
+				std::uint64_t oldestPinned = std::numeric_limits<std::uint64_t>::max();
+				for (const ReaderSlot& slot : m_Readers)
+				{
+					const std::uint64_t epoch = slot.Epoch.load(std::memory_order_seq_cst);
+					if (epoch != Unpinned)
+					{
+						oldestPinned = std::min(oldestPinned, epoch);
+					}
+				}
+
+				std::erase_if(m_Retired, [oldestPinned](const Retired& retired)
+					{
+						if (retired.Epoch >= oldestPinned)
+							return false;
+
+						delete retired.Snapshot;
+						return true;
+					});
+			}
+
+			[[nodiscard]] std::size_t NumRetiredSnapshots() const { return m_Retired.size(); }
+
+		private:
+			// Threads are numbered in the order they first read, which spreads them over the slots evenly.
+			[[nodiscard]] static std::size_t FirstSlot()
+			{
+				static std::atomic<std::size_t> nextThread{ 0 };
+				thread_local const std::size_t first = nextThread.fetch_add(1, std::memory_order_relaxed) % MaxReaders;
+				return first;
+			}
+
+			SetType m_Writer;
+			std::atomic<const SetType*> m_Published;
+			std::atomic<std::uint64_t> m_Epoch;
+			mutable std::array<ReaderSlot, MaxReaders> m_Readers;
+			std::vector<Retired> m_Retired;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <array>
+
+namespace aZero
+{
+	namespace DS
+	{
+		namespace detail
+		{
+			// Smallest unsigned type that holds every value in [0, MaxValue].
+			template<std::size_t MaxValue>
+			using SmallestUnsigned =
+				std::conditional_t<MaxValue <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+				std::conditional_t<MaxValue <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+				std::conditional_t<MaxValue <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::uint64_t>>>;
+		}
+
+		// SparseSet with inline storage for IDs in [0, MaxID] and at most MaxElements elements. It never allocates and is usable in constant expressions.
+		// Dense indices are stored in the smallest type that fits MaxElements, so SparseSet<uint8_t, T> sized sets stay a few hundred bytes.
+		// Unlike SparseSet, ElementType has to be default constructible since every inline slot holds an element.
+		template<UnsignedInteger IDType, IsTriviallyCopyable ElementType, std::size_t MaxID, std::size_t MaxElements>
+		class FixedSparseSet
+		{
+			static_assert(MaxID <= std::numeric_limits<IDType>::max(), "MaxID has to be representable by IDType");
+			static_assert(MaxElements > 0 && MaxElements <= MaxID + 1, "MaxElements has to be in [1, MaxID + 1]");
+			static_assert(std::is_default_constructible_v<ElementType>, "FixedSparseSet keeps its elements in a std::array, so ElementType has to be default constructible");
+
+		public:
+			// Type of the dense indices kept in the sparse index, returned by GetElementIndex.
+			using IndexType = detail::SmallestUnsigned<MaxElements>;
+
+		private:
+			static constexpr IndexType EmptySlot{ std::numeric_limits<IndexType>::max() };
+
+		public:
+			using KeyType = IDType;
+			using ValueType = ElementType;
+
+			static constexpr std::size_t Capacity = MaxElements;
+
+			constexpr FixedSparseSet()
+			{
+				m_ID_To_Element.fill(EmptySlot);
+			}
+
+			// Returns false if id is already present. Throws std::out_of_range above MaxID and std::length_error when full.
+			constexpr bool Insert(IDType id, const ElementType& element)
+			{
+				if (id > MaxID)
+					throw std::out_of_range("FixedSparseSet::Insert: ID exceeds MaxID");
+
+				if (m_ID_To_Element[id] != EmptySlot)
+					return false;
+
+				if (m_CurrentLast == MaxElements)
+					throw std::length_error("FixedSparseSet::Insert: the set is full");
+
+				m_Elements[m_CurrentLast] = element;
+				m_Element_To_ID[m_CurrentLast] = id;
+				m_ID_To_Element[id] = static_cast<IndexType>(m_CurrentLast);
+				m_CurrentLast++;
+				return true;
+			}
+
+			constexpr bool Erase(IDType id)
+			{
+				if (!this->Exists(id))
+					return false;
+
+				const std::size_t removedIndex = m_ID_To_Element[id];
+				const std::size_t lastIndex = m_CurrentLast - 1;
+				if (removedIndex != lastIndex)
+				{
+					m_Elements[removedIndex] = m_Elements[lastIndex];
+					const IDType lastElementID = m_Element_To_ID[lastIndex];
+					m_Element_To_ID[removedIndex] = lastElementID;
+					m_ID_To_Element[lastElementID] = static_cast<IndexType>(removedIndex);
+				}
+				m_ID_To_Element[id] = EmptySlot;
+				m_CurrentLast--;
+				return true;
+			}
+
+			[[nodiscard]] constexpr bool Exists(IDType id) const
+			{
+				return id <= MaxID && m_ID_To_Element[id] != EmptySlot;
+			}
+
+			// Throws std::out_of_range if id isn't present.
+			[[nodiscard]] constexpr ElementType& Get(IDType id)
+			{
+				return m_Elements[this->ElementIndexOf(id)];
+			}
+
+			[[nodiscard]] constexpr const ElementType& Get(IDType id) const
+			{
+				return m_Elements[this->ElementIndexOf(id)];
+			}
+
+			[[nodiscard]] constexpr std::optional<std::reference_wrapper<ElementType>> GetIfExists(IDType id)
+			{
+				if (!this->Exists(id))
+					return std::nullopt;
+
+				return std::ref(m_Elements[m_ID_To_Element[id]]);
+			}
+
+			[[nodiscard]] constexpr std::optional<std::reference_wrapper<const ElementType>> GetIfExists(IDType id) const
+			{
+				if (!this->Exists(id))
+					return std::nullopt;
+
+				return std::cref(m_Elements[m_ID_To_Element[id]]);
+			}
+
+			[[nodiscard]] constexpr IndexType GetElementIndex(IDType id) const { return this->ElementIndexOf(id); }
+
+			[[nodiscard]] constexpr std::size_t Size() const { return m_CurrentLast; }
+
+			[[nodiscard]] constexpr bool Full() const { return m_CurrentLast == MaxElements; }
+
+			constexpr void Clear()
+			{
+				for (std::size_t i = 0; i < m_CurrentLast; i++)
+				{
+					m_ID_To_Element[m_Element_To_ID[i]] = EmptySlot;
+				}
+				m_CurrentLast = 0;
+			}
+
+			[[nodiscard]] constexpr std::span<ElementType> GetElements() { return { m_Elements.data(), m_CurrentLast }; }
+
+			[[nodiscard]] constexpr std::span<const ElementType> GetElements() const { return { m_Elements.data(), m_CurrentLast }; }
+
+			[[nodiscard]] constexpr std::span<const IDType> GetIDs() const { return { m_Element_To_ID.data(), m_CurrentLast }; }
+
+			[[nodiscard]] constexpr ElementType* begin() { return m_Elements.data(); }
+			[[nodiscard]] constexpr ElementType* end() { return m_Elements.data() + m_CurrentLast; }
+			[[nodiscard]] constexpr const ElementType* begin() const { return m_Elements.data(); }
+			[[nodiscard]] constexpr const ElementType* end() const { return m_Elements.data() + m_CurrentLast; }
+
+		private:
+			[[nodiscard]] constexpr IndexType ElementIndexOf(IDType id) const
+			{
+				if (!this->Exists(id))
+					throw std::out_of_range("FixedSparseSet::Get");
+
+				return m_ID_To_Element[id];
+			}
+
+			std::array<IndexType, MaxID + 1> m_ID_To_Element{};
+			std::array<IDType, MaxElements> m_Element_To_ID{};
+			std::array<ElementType, MaxElements> m_Elements{};
+			std::size_t m_CurrentLast = 0;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <tuple>
+
+namespace aZero
+{
+	namespace DS
+	{
+		// Iterates the IDs that are present in every one of the given SparseSets.
+		// Iteration is driven by the set with the fewest elements, the others are probed once per candidate ID.
+		// Any Insert or Erase on one of the sets invalidates the view and its iterators.
+		template<typename... Sets>
+		class JoinView
+		{
+			static_assert(sizeof...(Sets) > 0, "JoinView needs at least one SparseSet");
+
+			using FirstSet = std::remove_const_t<std::tuple_element_t<0, std::tuple<Sets...>>>;
+
+		public:
+			using IDType = typename FirstSet::KeyType;
+
+			static_assert((std::is_same_v<typename std::remove_const_t<Sets>::KeyType, IDType> && ...), "All SparseSets of a JoinView need the same IDType");
+
+			using ValueType = std::tuple<IDType, decltype(std::declval<Sets&>().GetUnchecked(IDType{}))...>;
+
+		private:
+			using Pointers = std::tuple<std::remove_reference_t<decltype(std::declval<Sets&>().GetUnchecked(IDType{}))>*...>;
+
+		public:
+			class Iterator
+			{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using difference_type = std::ptrdiff_t;
+				using value_type = ValueType;
+				using reference = ValueType;
+
+				Iterator() = default;
+
+				Iterator(const JoinView* view, std::size_t position)
+					:m_View(view), m_Position(position)
+				{
+					this->Seek();
+				}
+
+				[[nodiscard]] reference operator*() const
+				{
+					return std::apply([this](auto*... elements) { return ValueType{ m_View->m_DriverIDs[m_Position], *elements... }; }, m_Elements);
+				}
+
+				Iterator& operator++()
+				{
+					m_Position++;
+					this->Seek();
+					return *this;
+				}
+
+				Iterator operator++(int)
+				{
+					Iterator previous = *this;
+					++(*this);
+					return previous;
+				}
+
+				[[nodiscard]] bool operator==(const Iterator& other) const { return m_Position == other.m_Position; }
+
+			private:
+				void Seek()
+				{
+					while (m_Position < m_View->m_DriverIDs.size() && !m_View->Probe(m_Position, m_Elements))
+					{
+						m_Position++;
+					}
+				}
+
+				const JoinView* m_View = nullptr;
+				std::size_t m_Position = 0;
+				Pointers m_Elements{};
+			};
+
+			explicit JoinView(Sets&... sets)
+				:m_Sets(&sets...), m_Driver(0)
+			{
+				const std::size_t sizes[] = { sets.Size()... };
+				m_Driver = static_cast<std::size_t>(std::min_element(std::begin(sizes), std::end(sizes)) - std::begin(sizes));
+				this->SelectDriverIDs(std::index_sequence_for<Sets...>{});
+			}
+
+			[[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+
+			[[nodiscard]] Iterator end() const { return Iterator(this, m_DriverIDs.size()); }
+
+			// Calls func(id, elements&...) for every joined ID.
+			template<typename Func>
+			void Each(Func&& func) const
+			{
+				Pointers elements{};
+				for (std::size_t position = 0; position < m_DriverIDs.size(); position++)
+				{
+					if (this->Probe(position, elements))
+					{
+						std::apply([&](auto*... found) { func(m_DriverIDs[position], *found...); }, elements);
+					}
+				}
+			}
+
+			// Upper bound for the number of joined IDs, the size of the driving set.
+			[[nodiscard]] std::size_t SizeHint() const { return m_DriverIDs.size(); }
+
+		private:
+			template<std::size_t... I>
+			void SelectDriverIDs(std::index_sequence<I...>)
+			{
+				((I == m_Driver ? (m_DriverIDs = std::get<I>(m_Sets)->GetIDs(), 0) : 0), ...);
+			}
+
+			template<std::size_t I>
+			[[nodiscard]] bool ProbeSet(IDType id, std::size_t position, Pointers& elements) const
+			{
+				auto* set = std::get<I>(m_Sets);
+				if (I == m_Driver)
+				{
+					std::get<I>(elements) = set->GetElements().data() + position;
+					return true;
+				}
+
+				const auto elementIndex = set->FindElementIndex(id);
+				if (elementIndex == set->InvalidIndex)
+					return false;
+
+				std::get<I>(elements) = set->GetElements().data() + elementIndex;
+				return true;
+			}
+
+			template<std::size_t... I>
+			[[nodiscard]] bool ProbeAll(std::size_t position, Pointers& elements, std::index_sequence<I...>) const
+			{
+				const IDType id = m_DriverIDs[position];
+				return (this->ProbeSet<I>(id, position, elements) && ...);
+			}
+
+			[[nodiscard]] bool Probe(std::size_t position, Pointers& elements) const
+			{
+				return this->ProbeAll(position, elements, std::index_sequence_for<Sets...>{});
+			}
+
+			std::tuple<Sets*...> m_Sets;
+			std::span<const IDType> m_DriverIDs;
+			std::size_t m_Driver;
+		};
+
+		// Word-at-a-time AND of the occupancy bitsets of sets built with Config::OccupancyBits. Bit i % 64 of word i / 64 is set if ID index i is in every set.
+		template<typename... Sets>
+		[[nodiscard]] std::vector<std::uint64_t> IntersectOccupancy(const Sets&... sets)
+		{
+			static_assert(sizeof...(Sets) > 0, "IntersectOccupancy needs at least one SparseSet");
+
+			std::vector<std::uint64_t> words(std::min({ sets.NumOccupancyWords()... }), ~std::uint64_t(0));
+			for (std::size_t i = 0; i < words.size(); i++)
+			{
+				((words[i] &= sets.GetOccupancyWord(i)), ...);
+			}
+			return words;
+		}
+
+		// Word-at-a-time OR of the occupancy bitsets, bit i is set if ID index i is in any of the sets.
+		template<typename... Sets>
+		[[nodiscard]] std::vector<std::uint64_t> UniteOccupancy(const Sets&... sets)
+		{
+			static_assert(sizeof...(Sets) > 0, "UniteOccupancy needs at least one SparseSet");
+
+			std::vector<std::uint64_t> words(std::max({ sets.NumOccupancyWords()... }), 0);
+			auto unite = [&words](const auto& set)
+				{
+					for (std::size_t i = 0; i < set.NumOccupancyWords(); i++)
+					{
+						words[i] |= set.GetOccupancyWord(i);
+					}
+				};
+			(unite(sets), ...);
+			return words;
+		}
+
+		// Calls func(id, elements&...) for every ID present in all the sets, in ascending ID order.
+		// The summary words are intersected first so that ranges of 4096 IDs missing from any set are skipped with one AND.
+		// Needs unversioned sets built with Config::OccupancyBits. Like JoinView, the sets must not be modified during the walk.
+		template<typename Func, typename... Sets>
+		void ForEachIntersection(Func&& func, Sets&... sets)
+		{
+			static_assert(sizeof...(Sets) > 0, "ForEachIntersection needs at least one SparseSet");
+			static_assert(((!std::remove_const_t<Sets>::IsVersioned) && ...), "ForEachIntersection needs unversioned IDs");
+
+			using IDType = typename std::remove_const_t<std::tuple_element_t<0, std::tuple<Sets...>>>::KeyType;
+
+			const std::size_t numSummaryWords = std::min({ sets.GetOccupancySummary().size()... });
+			for (std::size_t summaryIndex = 0; summaryIndex < numSummaryWords; summaryIndex++)
+			{
+				for (std::uint64_t summary = (sets.GetOccupancySummary()[summaryIndex] & ...); summary != 0; summary &= summary - 1)
+				{
+					const std::size_t wordIndex = summaryIndex * 64 + static_cast<std::size_t>(std::countr_zero(summary));
+					for (std::uint64_t word = (sets.GetOccupancyWord(wordIndex) & ...); word != 0; word &= word - 1)
+					{
+						const IDType id = static_cast<IDType>(wordIndex * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+						func(id, sets.GetUnchecked(id)...);
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
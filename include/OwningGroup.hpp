@@ -0,0 +1,99 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <tuple>
+
+namespace aZero
+{
+	namespace DS
+	{
+		// Keeps the IDs that are present in all owned SparseSets packed at the front of every set's dense array, in the same order.
+		// Element i of each set's group range belongs to the same ID, so iterating the group is a linear walk over parallel arrays.
+		// The group registers itself as the observer of every owned set. Owned sets must outlive the group and must not be moved or reordered by anything else while owned.
+		template<typename... Sets>
+		class OwningGroup : private SparseSetObserver<typename std::tuple_element_t<0, std::tuple<Sets...>>::KeyType>
+		{
+			static_assert(sizeof...(Sets) > 1, "OwningGroup needs at least two SparseSets");
+
+		public:
+			using IDType = typename std::tuple_element_t<0, std::tuple<Sets...>>::KeyType;
+
+			static_assert((std::is_same_v<typename Sets::KeyType, IDType> && ...), "All SparseSets of an OwningGroup need the same IDType");
+
+			explicit OwningGroup(Sets&... sets)
+				:m_Sets(&sets...), m_Size(0)
+			{
+				if ((sets.GetObserver() || ...))
+					throw std::logic_error("OwningGroup: a set is already owned or observed");
+
+				(sets.SetObserver(this), ...);
+
+				std::vector<IDType> candidates;
+				std::span<const IDType> ids = std::get<0>(m_Sets)->GetIDs();
+				candidates.assign(ids.begin(), ids.end());
+				for (const IDType id : candidates)
+				{
+					this->OnInserted(id);
+				}
+			}
+
+			OwningGroup(const OwningGroup&) = delete;
+			OwningGroup& operator=(const OwningGroup&) = delete;
+
+			~OwningGroup()
+			{
+				std::apply([](auto*... sets) { (sets->SetObserver(nullptr), ...); }, m_Sets);
+			}
+
+			[[nodiscard]] std::size_t Size() const { return m_Size; }
+
+			[[nodiscard]] bool Contains(IDType id) const
+			{
+				return std::get<0>(m_Sets)->Contains(id) && std::get<0>(m_Sets)->GetElementIndex(id) < m_Size;
+			}
+
+			[[nodiscard]] std::span<const IDType> GetIDs() const { return std::get<0>(m_Sets)->GetIDs().first(m_Size); }
+
+			// The group range of the I:th owned set, parallel to GetIDs().
+			template<std::size_t I>
+			[[nodiscard]] auto GetElements() const { return std::get<I>(m_Sets)->GetElements().first(m_Size); }
+
+			// Calls func(id, elements&...) for every ID in the group.
+			template<typename Func>
+			void Each(Func&& func) const
+			{
+				const std::span<const IDType> ids = this->GetIDs();
+				std::apply([&](auto*... sets)
+					{
+						auto elements = std::make_tuple(sets->GetElements().data()...);
+						for (std::size_t i = 0; i < ids.size(); i++)
+						{
+							std::apply([&](auto*... element) { func(ids[i], element[i]...); }, elements);
+						}
+					}, m_Sets);
+			}
+
+		private:
+			void OnInserted(IDType id) override
+			{
+				const bool inAll = std::apply([id](auto*... sets) { return (sets->Contains(id) && ...); }, m_Sets);
+				if (!inAll || std::get<0>(m_Sets)->GetElementIndex(id) < m_Size)
+					return;
+
+				std::apply([this, id](auto*... sets) { (sets->SwapAt(sets->GetElementIndex(id), static_cast<decltype(sets->GetElementIndex(id))>(m_Size)), ...); }, m_Sets);
+				m_Size++;
+			}
+
+			void OnErasing(IDType id) override
+			{
+				if (!this->Contains(id))
+					return;
+
+				m_Size--;
+				std::apply([this, id](auto*... sets) { (sets->SwapAt(sets->GetElementIndex(id), static_cast<decltype(sets->GetElementIndex(id))>(m_Size)), ...); }, m_Sets);
+			}
+
+			std::tuple<Sets*...> m_Sets;
+			std::size_t m_Size;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <tuple>
+
+namespace aZero
+{
+	namespace DS
+	{
+		// Describes how an element type is split into fields.
+		// std::tuple<Fields...> is split into its elements. An aggregate can opt in by listing its members:
+		//	struct Transform { Vec3 Position; Quat Rotation; static constexpr auto SoAMembers = std::make_tuple(&Transform::Position, &Transform::Rotation); };
+		template<typename T>
+		struct SoALayout;
+
+		template<IsTriviallyCopyable... Fields>
+		struct SoALayout<std::tuple<Fields...>>
+		{
+			using FieldTuple = std::tuple<Fields...>;
+
+			[[nodiscard]] static std::tuple<const Fields&...> Split(const std::tuple<Fields...>& element)
+			{
+				return std::apply([](const Fields&... fields) { return std::tuple<const Fields&...>(fields...); }, element);
+			}
+
+			[[nodiscard]] static std::tuple<Fields...> Join(const Fields&... fields) { return { fields... }; }
+		};
+
+		namespace detail
+		{
+			template<typename T, typename Members>
+			struct SoAMemberFields;
+
+			template<typename T, typename... Members>
+			struct SoAMemberFields<T, std::tuple<Members T::*...>>
+			{
+				using Type = std::tuple<Members...>;
+			};
+		}
+
+		template<typename T>
+			requires requires { T::SoAMembers; }
+		struct SoALayout<T>
+		{
+			using FieldTuple = typename detail::SoAMemberFields<T, std::remove_const_t<decltype(T::SoAMembers)>>::Type;
+
+			[[nodiscard]] static auto Split(const T& element)
+			{
+				return std::apply([&element](auto... members) { return std::forward_as_tuple(element.*members...); }, T::SoAMembers);
+			}
+
+			template<typename... Fields>
+			[[nodiscard]] static T Join(const Fields&... fields)
+			{
+				T element{};
+				std::apply([&](auto... members) { ((element.*members = fields), ...); }, T::SoAMembers);
+				return element;
+			}
+		};
+
+		// Stores every field of ElementType in its own dense array so that loops touching one field only stream that field.
+		// Uses the same sparse index, config and swap-and-pop erase as SparseSet, every field array is moved in lockstep.
+		// Config::IndexType and IndexOverflow apply like for SparseSet. Versions, change tracking, occupancy bits and stats aren't supported.
+		template<UnsignedInteger IDType, typename ElementType, typename Config = DefaultSparseSetConfig>
+		class SoASparseSet
+		{
+			using Layout = SoALayout<ElementType>;
+			using FieldTuple = typename Layout::FieldTuple;
+			using IndexType = detail::SparseIndexTypeOf<IDType, Config>;
+			using SparseIndexType = typename detail::SelectSparseIndex<IndexType, Config::SparsePageSize, typename Config::Allocator>::Type;
+
+			template<typename T>
+			using DenseVector = std::vector<T, detail::RebindAllocator<typename Config::Allocator, T>>;
+
+			template<typename Fields>
+			struct Storage;
+
+			template<typename... Fields>
+			struct Storage<std::tuple<Fields...>>
+			{
+				static_assert((std::is_trivially_copyable_v<Fields> && ...), "SoASparseSet fields have to be trivially copyable");
+
+				using Arrays = std::tuple<DenseVector<Fields>...>;
+				using References = std::tuple<Fields&...>;
+				using ConstReferences = std::tuple<const Fields&...>;
+
+				[[nodiscard]] static Arrays MakeArrays(const typename Config::Allocator& allocator)
+				{
+					return Arrays(DenseVector<Fields>(allocator)...);
+				}
+			};
+
+			using FieldStorage = Storage<FieldTuple>;
+
+			static_assert(Config::VersionBits == 0, "SoASparseSet doesn't support versioned IDs");
+			static_assert(!Config::TrackChanges, "SoASparseSet doesn't support change tracking");
+			static_assert(!Config::OccupancyBits, "SoASparseSet doesn't support occupancy bits");
+			static_assert(std::is_same_v<typename Config::Stats, NoStats>, "SoASparseSet doesn't support stats");
+
+		public:
+			using KeyType = IDType;
+			using ValueType = ElementType;
+			using ConfigType = Config;
+			using AllocatorType = typename Config::Allocator;
+			using Reference = typename FieldStorage::References;
+			using ConstReference = typename FieldStorage::ConstReferences;
+
+			static constexpr IndexType InvalidIndex{ std::numeric_limits<IndexType>::max() };
+			static constexpr bool IsChecked = Config::CheckedAccess;
+			static constexpr std::size_t MaxID = detail::EffectiveMaxID<Config, IDType>;
+
+			// Upper bound for Size(), the largest IndexType value is reserved for InvalidIndex.
+			static constexpr std::size_t MaxElements = InvalidIndex;
+
+			template<std::size_t I>
+			using FieldType = std::tuple_element_t<I, FieldTuple>;
+
+			SoASparseSet() = default;
+
+			explicit SoASparseSet(const AllocatorType& allocator)
+				:m_ID_To_Element(allocator), m_Element_To_ID(allocator), m_Fields(FieldStorage::MakeArrays(allocator)){ }
+
+			SoASparseSet(IDType numElements, const AllocatorType& allocator = AllocatorType())
+				:m_ID_To_Element(numElements, allocator), m_Element_To_ID(allocator), m_Fields(FieldStorage::MakeArrays(allocator)){ }
+
+			bool Insert(IDType id, const ElementType& element)
+			{
+				if (this->Exists(id))
+					return false;
+
+				detail::CheckCapacity<Config, MaxElements>(m_Element_To_ID.size() + 1, "SoASparseSet::Insert: Size() would exceed MaxElements");
+				detail::PrepareSparseSlot<Config, IsChecked, MaxID>(m_ID_To_Element, id);
+				std::apply([this](const auto&... fields) { this->PushFields(fields...); }, Layout::Split(element));
+				m_Element_To_ID.push_back(id);
+				m_ID_To_Element.SetUnchecked(id, static_cast<IndexType>(m_Element_To_ID.size() - 1));
+				return true;
+			}
+
+			bool Erase(IDType id)
+			{
+				const IndexType removedIndex = m_ID_To_Element.Find(id);
+				if (removedIndex == InvalidIndex)
+					return false;
+
+				const IndexType lastIndex = static_cast<IndexType>(m_Element_To_ID.size() - 1);
+				if (removedIndex != lastIndex)
+				{
+					std::apply([=](auto&... arrays) { ((arrays[removedIndex] = arrays[lastIndex]), ...); }, m_Fields);
+					const IDType lastElementID = m_Element_To_ID[lastIndex];
+					m_Element_To_ID[removedIndex] = lastElementID;
+					m_ID_To_Element.SetUnchecked(lastElementID, removedIndex);
+				}
+				std::apply([](auto&... arrays) { (arrays.pop_back(), ...); }, m_Fields);
+				m_Element_To_ID.pop_back();
+				m_ID_To_Element.SetUnchecked(id, InvalidIndex);
+				return true;
+			}
+
+			[[nodiscard]] bool Exists(IDType id) const
+			{
+				return m_ID_To_Element.Find(id) != InvalidIndex;
+			}
+
+			// Returns a tuple of references into every field array.
+			[[nodiscard]] Reference Get(IDType id)
+			{
+				return this->FieldsAt(m_Fields, this->LoadSlot(id));
+			}
+
+			[[nodiscard]] ConstReference Get(IDType id) const
+			{
+				return this->FieldsAt(m_Fields, this->LoadSlot(id));
+			}
+
+			template<std::size_t I>
+			[[nodiscard]] FieldType<I>& GetField(IDType id)
+			{
+				return std::get<I>(m_Fields)[this->LoadSlot(id)];
+			}
+
+			template<std::size_t I>
+			[[nodiscard]] const FieldType<I>& GetField(IDType id) const
+			{
+				return std::get<I>(m_Fields)[this->LoadSlot(id)];
+			}
+
+			// Reassembles the element from its fields.
+			[[nodiscard]] ElementType Load(IDType id) const
+			{
+				return std::apply([](const auto&... fields) { return ElementType(Layout::Join(fields...)); }, this->Get(id));
+			}
+
+			// The live dense range of one field, parallel to GetIDs().
+			template<std::size_t I>
+			[[nodiscard]] std::span<FieldType<I>> GetFieldSpan() { return std::get<I>(m_Fields); }
+
+			template<std::size_t I>
+			[[nodiscard]] std::span<const FieldType<I>> GetFieldSpan() const { return std::get<I>(m_Fields); }
+
+			[[nodiscard]] std::span<const IDType> GetIDs() const { return m_Element_To_ID; }
+
+			[[nodiscard]] std::size_t Size() const { return m_Element_To_ID.size(); }
+
+			// Calls func(id, fields&...) for every live element.
+			template<typename Func>
+			void Each(Func&& func)
+			{
+				for (std::size_t i = 0; i < m_Element_To_ID.size(); i++)
+				{
+					std::apply([&](auto&... fields) { func(m_Element_To_ID[i], fields...); }, this->FieldsAt(m_Fields, i));
+				}
+			}
+
+			void Reserve(IDType numEntries)
+			{
+				m_ID_To_Element.Resize(numEntries);
+			}
+
+			void ReserveElements(std::size_t numElements)
+			{
+				std::apply([=](auto&... arrays) { (arrays.reserve(numElements), ...); }, m_Fields);
+				m_Element_To_ID.reserve(numElements);
+			}
+
+			void ShrinkToFit()
+			{
+				std::apply([](auto&... arrays) { (arrays.shrink_to_fit(), ...); }, m_Fields);
+				m_Element_To_ID.shrink_to_fit();
+			}
+
+			[[nodiscard]] std::size_t NumSupportedElements() const
+			{
+				return m_ID_To_Element.Size();
+			}
+
+			[[nodiscard]] IndexType GetElementIndex(IDType id) const { return this->LoadSlot(id); }
+
+		private:
+			template<typename Arrays>
+			[[nodiscard]] static auto FieldsAt(Arrays& arrays, std::size_t index)
+			{
+				return std::apply([=](auto&... array) { return std::tie(array[index]...); }, arrays);
+			}
+
+			[[nodiscard]] IndexType LoadSlot(IDType id) const
+			{
+				if constexpr (IsChecked)
+				{
+					const IndexType index = m_ID_To_Element.At(id);
+					if (index == InvalidIndex)
+						throw std::out_of_range("SoASparseSet::Get");
+
+					return index;
+				}
+				else
+				{
+					return m_ID_To_Element.Slot(id);
+				}
+			}
+
+			template<typename... Fields>
+			void PushFields(const Fields&... fields)
+			{
+				std::apply([&](auto&... arrays) { (arrays.push_back(fields), ...); }, m_Fields);
+			}
+
+			SparseIndexType m_ID_To_Element;
+			DenseVector<IDType> m_Element_To_ID;
+			typename FieldStorage::Arrays m_Fields;
+		};
+	}
+}
\ No newline at end of file
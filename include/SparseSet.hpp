@@ -2,6 +2,46 @@
 #include <vector>
 #include <optional>
 #include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <span>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <cstring>
+#include <memory_resource>
+#include <numeric>
+#include <thread>
+#include <string>
+#include <concepts>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <condition_variable>
+
+#if defined(__AVX2__) || defined(__AVX512F__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#include <immintrin.h>
+#endif
+
+#ifndef AZERO_SPARSE_SET_CHECKED_ACCESS
+#define AZERO_SPARSE_SET_CHECKED_ACCESS 1
+#endif
+
+// 1 runs StdParallelExecutor on std::execution::par, which with libstdc++ needs TBB at link time (-ltbb).
+// 0 keeps the library dependency free, StdParallelExecutor then runs the chunks on a persistent pool of std::thread workers.
+#ifndef AZERO_SPARSE_SET_PARALLEL_STL
+#define AZERO_SPARSE_SET_PARALLEL_STL 0
+#endif
+
+#if AZERO_SPARSE_SET_PARALLEL_STL
+#include <execution>
+#endif
 
 namespace aZero
 {
@@ -17,160 +57,3147 @@ namespace aZero
 		template<typename T>
 		concept IsTriviallyCopyable = std::is_trivially_copyable_v<T>;
 
-		template<UnsignedInteger IDType, IsTriviallyCopyable ElementType>
-		class SparseSet
+		template<typename T>
+		concept IsMovable = std::movable<T>;
+
+		// True for types whose objects can be moved to another address by copying their bytes, with the source then treated as gone.
+		// Trivially copyable types are. Other types opt in by specializing it, which lets SparseSet swap them bytewise instead of through three moves.
+		template<typename T>
+		struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> { };
+
+		// What happens when an insert would push Size() past SparseSet::MaxElements.
+		// Throw raises std::length_error, Assert only checks in debug builds and leaves the overflow to the caller.
+		enum class IndexOverflowPolicy
+		{
+			Throw,
+			Assert
+		};
+
+		// Which element SparseSet::Build keeps when an ID index occurs more than once in its input.
+		// Throw raises std::invalid_argument instead.
+		enum class DuplicateIDPolicy
+		{
+			FirstWins,
+			LastWins,
+			Throw
+		};
+
+		// Counters reported by SparseSet::GetStats.
+		struct SparseSetStats
+		{
+			std::uint64_t Inserts = 0;
+			std::uint64_t Erases = 0;
+			std::uint64_t FailedLookups = 0;
+			std::uint64_t SparseResizes = 0;
+			std::uint64_t ShrinkToFits = 0;
+			std::size_t DenseCapacity = 0;
+			std::size_t PeakDenseCapacity = 0;
+			std::size_t SparseSize = 0;
+			std::size_t PeakSparseSize = 0;
+		};
+
+		// Bytes held by a SparseSet, see SparseSet::MemoryUsage. Live bytes back the Size() present elements, reserved bytes are allocated.
+		struct SparseSetMemoryUsage
+		{
+			std::size_t SparseLiveBytes = 0;
+			std::size_t SparseReservedBytes = 0;
+			std::size_t ReverseIDLiveBytes = 0;
+			std::size_t ReverseIDReservedBytes = 0;
+			std::size_t DenseLiveBytes = 0;
+			std::size_t DenseReservedBytes = 0;
+
+			// Occupancy bits and change tracking, 0 unless enabled in the config.
+			std::size_t AuxiliaryReservedBytes = 0;
+
+			[[nodiscard]] std::size_t TotalLiveBytes() const { return SparseLiveBytes + ReverseIDLiveBytes + DenseLiveBytes; }
+			[[nodiscard]] std::size_t TotalReservedBytes() const { return SparseReservedBytes + ReverseIDReservedBytes + DenseReservedBytes + AuxiliaryReservedBytes; }
+			[[nodiscard]] std::size_t WastedBytes() const { return TotalReservedBytes() - TotalLiveBytes(); }
+		};
+
+		// Stats policies receive the hot path events of a SparseSet through these hooks and are selected with Config::Stats.
+		// Failed lookups are the misses of Exists, GetIfExists and ForEachGet. A custom policy can forward the hooks to a profiler and may add a Snapshot() for GetStats.
+		// The hooks of NoStats are empty, so the default costs nothing.
+		struct NoStats
+		{
+			void OnInsert(std::size_t) { }
+			void OnErase(std::size_t) { }
+			void OnFailedLookup() { }
+			void OnSparseResize(std::size_t) { }
+			void OnDenseResize(std::size_t) { }
+			void OnShrinkToFit() { }
+		};
+
+		namespace detail
+		{
+			inline void CountSparseResize(SparseSetStats& stats, std::size_t numSlots)
+			{
+				stats.SparseResizes++;
+				stats.SparseSize = numSlots;
+				stats.PeakSparseSize = std::max(stats.PeakSparseSize, numSlots);
+			}
+
+			inline void CountDenseResize(SparseSetStats& stats, std::size_t capacity)
+			{
+				stats.DenseCapacity = capacity;
+				stats.PeakDenseCapacity = std::max(stats.PeakDenseCapacity, capacity);
+			}
+		}
+
+		// Counts into the set itself. Not synchronized, concurrent readers of one set race on FailedLookups.
+		class CountingStats
+		{
+		public:
+			void OnInsert(std::size_t count) { m_Stats.Inserts += count; }
+			void OnErase(std::size_t count) { m_Stats.Erases += count; }
+			void OnFailedLookup() { m_Stats.FailedLookups++; }
+			void OnSparseResize(std::size_t numSlots) { detail::CountSparseResize(m_Stats, numSlots); }
+			void OnDenseResize(std::size_t capacity) { detail::CountDenseResize(m_Stats, capacity); }
+			void OnShrinkToFit() { m_Stats.ShrinkToFits++; }
+
+			[[nodiscard]] SparseSetStats Snapshot() const { return m_Stats; }
+
+		private:
+			SparseSetStats m_Stats;
+		};
+
+		// Counts into one thread_local SparseSetStats shared by every set using this policy on the calling thread. Safe for concurrent readers.
+		class ThreadCountingStats
 		{
 		public:
-			static constexpr IDType InvalidIndex{ std::numeric_limits<IDType>::max() };
+			void OnInsert(std::size_t count) { Counters().Inserts += count; }
+			void OnErase(std::size_t count) { Counters().Erases += count; }
+			void OnFailedLookup() { Counters().FailedLookups++; }
+			void OnSparseResize(std::size_t numSlots) { detail::CountSparseResize(Counters(), numSlots); }
+			void OnDenseResize(std::size_t capacity) { detail::CountDenseResize(Counters(), capacity); }
+			void OnShrinkToFit() { Counters().ShrinkToFits++; }
+
+			[[nodiscard]] SparseSetStats Snapshot() const { return Counters(); }
+
+			static void Reset() { Counters() = SparseSetStats(); }
+
+		private:
+			[[nodiscard]] static SparseSetStats& Counters()
+			{
+				thread_local SparseSetStats counters;
+				return counters;
+			}
+		};
+
+		struct DefaultSparseSetConfig
+		{
+			// Number of IDs covered by one page of the sparse index.
+			// 0 keeps the sparse index as one flat array over the whole ID range.
+			static constexpr std::size_t SparsePageSize = 0;
+
+			// true routes lookups through bounds-checked accessors that throw std::out_of_range.
+			// false uses unchecked indexing that is only asserted in debug builds.
+			static constexpr bool CheckedAccess = AZERO_SPARSE_SET_CHECKED_ACCESS;
+
+			// Insert grows the sparse index to fit new IDs instead of requiring a Reserve() up front.
+			// The sparse length is multiplied by SparseGrowthFactor (or raised to the ID if that is larger) and never exceeds MaxID + 1.
+			static constexpr bool GrowOnInsert = true;
+			static constexpr double SparseGrowthFactor = 2.0;
+			static constexpr std::size_t MaxID = std::numeric_limits<std::size_t>::max();
+
+			// Allocates the sparse index, its pages and the dense arrays. Rebound to each stored type.
+			using Allocator = std::allocator<std::byte>;
+
+			// Number of high ID bits that hold a version, see VersionedIDTraits. 0 uses the whole ID as index.
+			static constexpr unsigned VersionBits = 0;
+
+			// Default number of IDs ForEachGet prefetches ahead, see SparseSet::ForEachGet.
+			static constexpr std::size_t PrefetchDistance = 16;
+
+			// Smallest amount of dense element bytes handed to one worker by ParallelForEach.
+			static constexpr std::size_t ParallelMinChunkBytes = 16 * 1024;
+
+			// Keeps a dirty bit per dense element and lists of the added and removed IDs, see SparseSet::ForEachDirty.
+			static constexpr bool TrackChanges = false;
+
+			// Keeps a two level bitset of the occupied ID indices next to the sparse index, see SparseSet::ForEachInIdOrder.
+			static constexpr bool OccupancyBits = false;
+
+			// Unsigned type of the dense indices stored in the sparse index, void uses IDType.
+			// A narrower type packs more slots per cache line and limits Size() to its range, see IndexOverflow.
+			using IndexType = void;
+			static constexpr IndexOverflowPolicy IndexOverflow = IndexOverflowPolicy::Throw;
+
+			// Receives insert, erase, failed lookup and resize events, see NoStats.
+			using Stats = NoStats;
+
+			// Erase compacts the set once Size() drops below AutoCompactLoadFactor times the dense capacity, see SparseSet::CompactIfNeeded.
+			// 0 disables it, values have to stay below 1. Sets with less than AutoCompactMinBytes of dense capacity are left alone.
+			static constexpr double AutoCompactLoadFactor = 0.0;
+			static constexpr std::size_t AutoCompactMinBytes = 64 * 1024;
+		};
+
+		template<std::size_t PageSize>
+		struct PagedSparseSetConfig : DefaultSparseSetConfig
+		{
+			static constexpr std::size_t SparsePageSize = PageSize;
+		};
+
+		struct UncheckedSparseSetConfig : DefaultSparseSetConfig
+		{
+			static constexpr bool CheckedAccess = false;
+		};
+
+		struct PmrSparseSetConfig : DefaultSparseSetConfig
+		{
+			using Allocator = std::pmr::polymorphic_allocator<std::byte>;
+		};
+
+		struct TrackedSparseSetConfig : DefaultSparseSetConfig
+		{
+			static constexpr bool TrackChanges = true;
+		};
+
+		struct OccupancySparseSetConfig : DefaultSparseSetConfig
+		{
+			static constexpr bool OccupancyBits = true;
+		};
+
+		struct CountingSparseSetConfig : DefaultSparseSetConfig
+		{
+			using Stats = CountingStats;
+		};
+
+		// SparseSet<IDType, ElementType, Index> is shorthand for SparseSet<IDType, ElementType, CompactIndexConfig<Index>>.
+		template<UnsignedInteger Index>
+		struct CompactIndexConfig : DefaultSparseSetConfig
+		{
+			using IndexType = Index;
+		};
 
-			SparseSet()
-				:m_CurrentLast(0){ }
+		// Splits an ID into an index in the low bits and a version in the high VersionBits bits.
+		template<UnsignedInteger IDType, unsigned VersionBits>
+		struct VersionedIDTraits
+		{
+			static_assert(VersionBits < std::numeric_limits<IDType>::digits, "VersionBits has to leave room for the index");
+
+			static constexpr unsigned IndexBits = std::numeric_limits<IDType>::digits - VersionBits;
+			static constexpr IDType IndexMask = VersionBits == 0 ? std::numeric_limits<IDType>::max() : static_cast<IDType>((IDType(1) << IndexBits) - 1);
+			static constexpr IDType MaxVersion = VersionBits == 0 ? 0 : static_cast<IDType>(std::numeric_limits<IDType>::max() >> IndexBits);
 
-			SparseSet(IDType numElements)
-				:m_CurrentLast(0), m_ID_To_Element(numElements, InvalidIndex){ }
+			[[nodiscard]] static constexpr IDType IndexOf(IDType id) { return id & IndexMask; }
 
-			void Insert(IDType id, const ElementType& element)
+			[[nodiscard]] static constexpr IDType VersionOf(IDType id)
 			{
-				if (!this->Exists(id))
+				if constexpr (VersionBits == 0)
 				{
-					if (m_CurrentLast < m_Elements.size())
-					{
-						m_Elements.at(m_CurrentLast) = element;
-						m_Element_To_ID.at(m_CurrentLast) = id;
-					}
-					else
-					{
-						m_Elements.push_back(element);
-						m_Element_To_ID.push_back(id);
-					}
-					m_ID_To_Element.at(id) = m_CurrentLast;
-					m_CurrentLast++;
+					return 0;
+				}
+				else
+				{
+					return static_cast<IDType>(id >> IndexBits);
 				}
 			}
 
-			bool Insert(IDType id, ElementType&& element)
+			[[nodiscard]] static constexpr IDType Make(IDType index, IDType version)
+			{
+				if constexpr (VersionBits == 0)
+				{
+					return index;
+				}
+				else
+				{
+					return static_cast<IDType>((static_cast<IDType>(version & MaxVersion) << IndexBits) | (index & IndexMask));
+				}
+			}
+		};
+
+		// Default index/version split per ID width: 2 version bits for uint8_t, 4 for uint16_t, 12 for uint32_t and 32 for uint64_t.
+		template<UnsignedInteger IDType>
+		inline constexpr unsigned DefaultVersionBits = sizeof(IDType) == 8 ? 32 : sizeof(IDType) == 4 ? 12 : sizeof(IDType) == 2 ? 4 : 2;
+
+		template<UnsignedInteger IDType, unsigned Bits = DefaultVersionBits<IDType>>
+		struct GenerationalSparseSetConfig : DefaultSparseSetConfig
+		{
+			static constexpr unsigned VersionBits = Bits;
+		};
+
+		namespace detail
+		{
+			template<typename ConfigOrIndex>
+			struct ResolveSparseSetConfig
+			{
+				using Type = ConfigOrIndex;
+			};
+
+			template<UnsignedInteger Index>
+			struct ResolveSparseSetConfig<Index>
+			{
+				using Type = CompactIndexConfig<Index>;
+			};
+
+			template<UnsignedInteger IDType, typename Config>
+			using SparseIndexTypeOf = std::conditional_t<std::is_void_v<typename Config::IndexType>, IDType, typename Config::IndexType>;
+
+			template<typename Allocator, typename T>
+			using RebindAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+			template<UnsignedInteger IndexType, typename Allocator>
+			class FlatSparseIndex
 			{
-				if (!this->Exists(id))
+			public:
+				static constexpr IndexType Empty{ std::numeric_limits<IndexType>::max() };
+
+				FlatSparseIndex() = default;
+
+				explicit FlatSparseIndex(const Allocator& allocator)
+					:m_Slots(allocator){ }
+
+				FlatSparseIndex(std::size_t numIDs, const Allocator& allocator = Allocator())
+					:m_Slots(numIDs, Empty, allocator){ }
+
+				[[nodiscard]] IndexType Find(std::size_t id) const
+				{
+					return id < m_Slots.size() ? m_Slots[id] : Empty;
+				}
+
+				[[nodiscard]] IndexType At(std::size_t id) const { return m_Slots.at(id); }
+
+				[[nodiscard]] IndexType Slot(std::size_t id) const
+				{
+					assert(id < m_Slots.size());
+					return m_Slots[id];
+				}
+
+				void Set(std::size_t id, IndexType index) { m_Slots.at(id) = index; }
+
+				void SetUnchecked(std::size_t id, IndexType index)
+				{
+					assert(id < m_Slots.size());
+					m_Slots[id] = index;
+				}
+
+				void Resize(std::size_t numIDs)
 				{
-					if (m_CurrentLast < m_Elements.size())
+					if (numIDs > m_Slots.size())
 					{
-						m_Elements.at(m_CurrentLast) = std::move(element);
-						m_Element_To_ID.at(m_CurrentLast) = id;
+						m_Slots.resize(numIDs, Empty);
 					}
-					else
+				}
+
+				// Releases the slots from numIDs on, they have to be empty.
+				void Truncate(std::size_t numIDs)
+				{
+					if (numIDs < m_Slots.size())
 					{
-						m_Elements.push_back(std::move(element));
-						m_Element_To_ID.push_back(id);
+						m_Slots.resize(numIDs);
+						m_Slots.shrink_to_fit();
 					}
-					m_ID_To_Element.at(id) = m_CurrentLast;
-					m_CurrentLast++;
-					return true;
 				}
-				return false;
-			}
 
-			bool Erase(IDType id)
+				[[nodiscard]] std::size_t Size() const { return m_Slots.size(); }
+
+				[[nodiscard]] std::size_t ReservedBytes() const { return m_Slots.capacity() * sizeof(IndexType); }
+
+				[[nodiscard]] IndexType* Data() { return m_Slots.data(); }
+				[[nodiscard]] const IndexType* Data() const { return m_Slots.data(); }
+
+				[[nodiscard]] const IndexType* SlotAddress(std::size_t id) const
+				{
+					return id < m_Slots.size() ? m_Slots.data() + id : nullptr;
+				}
+
+			private:
+				std::vector<IndexType, RebindAllocator<Allocator, IndexType>> m_Slots;
+			};
+
+			// Pages are allocated when the first ID inside them is set and released again once their last ID is reset.
+			template<UnsignedInteger IndexType, std::size_t PageSize, typename Allocator>
+			class PagedSparseIndex
 			{
-				if (this->Exists(id))
+				static_assert(std::has_single_bit(PageSize), "SparsePageSize has to be a power of two");
+
+				static constexpr std::size_t PageShift = std::countr_zero(PageSize);
+				static constexpr std::size_t PageMask = PageSize - 1;
+
+				struct Page
+				{
+					IndexType Slots[PageSize];
+					std::size_t NumLive = 0;
+				};
+
+				using PageAllocator = RebindAllocator<Allocator, Page>;
+				using PageAllocatorTraits = std::allocator_traits<PageAllocator>;
+
+			public:
+				static constexpr IndexType Empty{ std::numeric_limits<IndexType>::max() };
+
+				PagedSparseIndex() = default;
+
+				explicit PagedSparseIndex(const Allocator& allocator)
+					:m_Pages(allocator), m_PageAllocator(allocator){ }
+
+				PagedSparseIndex(std::size_t numIDs, const Allocator& allocator = Allocator())
+					:m_Pages(allocator), m_PageAllocator(allocator)
+				{
+					this->Resize(numIDs);
+				}
+
+				PagedSparseIndex(const PagedSparseIndex& other)
+					:m_Pages(std::allocator_traits<PageTableAllocator>::select_on_container_copy_construction(other.m_Pages.get_allocator())),
+					m_PageAllocator(PageAllocatorTraits::select_on_container_copy_construction(other.m_PageAllocator))
+				{
+					this->CopyPages(other);
+				}
+
+				PagedSparseIndex(PagedSparseIndex&& other) noexcept
+					:m_Pages(std::move(other.m_Pages)), m_PageAllocator(other.m_PageAllocator)
+				{
+					other.m_Pages.clear();
+				}
+
+				~PagedSparseIndex()
+				{
+					this->FreePages();
+				}
+
+				PagedSparseIndex& operator=(const PagedSparseIndex& other)
 				{
-					const IDType LastIndex = m_CurrentLast - 1;
-					const IDType RemovedElementIndex = m_ID_To_Element.at(id);
-					if (RemovedElementIndex != LastIndex)
+					if (this != &other)
 					{
-						m_Elements.at(RemovedElementIndex) = std::move(m_Elements.at(LastIndex));
-						const IDType LastElementID = m_Element_To_ID.at(LastIndex);
-						m_ID_To_Element.at(LastElementID) = RemovedElementIndex;
-						m_Element_To_ID.at(RemovedElementIndex) = LastElementID;
+						this->FreePages();
+						if constexpr (PageAllocatorTraits::propagate_on_container_copy_assignment::value)
+						{
+							m_PageAllocator = other.m_PageAllocator;
+						}
+						m_Pages = other.m_Pages;
+						this->CopyPages(other);
 					}
-					m_ID_To_Element.at(id) = InvalidIndex;
-					m_CurrentLast--;
-					return true;
+					return *this;
 				}
-				return false;
-			}
 
-			[[nodiscard]] ElementType& Get(IDType id)
-			{
-				const IDType elementIndex = m_ID_To_Element.at(id);
-				return m_Elements.at(elementIndex);
-			}
+				PagedSparseIndex& operator=(PagedSparseIndex&& other)
+				{
+					if (this != &other)
+					{
+						this->FreePages();
+						if constexpr (PageAllocatorTraits::propagate_on_container_move_assignment::value || PageAllocatorTraits::is_always_equal::value)
+						{
+							if constexpr (PageAllocatorTraits::propagate_on_container_move_assignment::value)
+							{
+								m_PageAllocator = other.m_PageAllocator;
+							}
+							m_Pages = std::move(other.m_Pages);
+							other.m_Pages.clear();
+						}
+						else if (m_PageAllocator == other.m_PageAllocator)
+						{
+							m_Pages = std::move(other.m_Pages);
+							other.m_Pages.clear();
+						}
+						else
+						{
+							m_Pages = other.m_Pages;
+							this->CopyPages(other);
+						}
+					}
+					return *this;
+				}
 
-			[[nodiscard]] const ElementType& Get(IDType id) const
-			{
-				const IDType elementIndex = m_ID_To_Element.at(id);
-				return m_Elements.at(elementIndex);
-			}
+				[[nodiscard]] IndexType Find(std::size_t id) const
+				{
+					const std::size_t pageIndex = id >> PageShift;
+					if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex])
+						return Empty;
 
-			[[nodiscard]] std::optional<std::reference_wrapper<ElementType>> GetIfExists(IDType id)
-			{
-				if (this->Exists(id))
+					return m_Pages[pageIndex]->Slots[id & PageMask];
+				}
+
+				// nullptr if id lies in an unallocated page.
+				[[nodiscard]] const IndexType* SlotAddress(std::size_t id) const
 				{
-					return std::optional<std::reference_wrapper<ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.at(id)))};
+					const std::size_t pageIndex = id >> PageShift;
+					if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex])
+						return nullptr;
+
+					return m_Pages[pageIndex]->Slots + (id & PageMask);
 				}
-				else
+
+				[[nodiscard]] IndexType At(std::size_t id) const
 				{
-					return std::nullopt;
+					if (id >= this->Size())
+						throw std::out_of_range("PagedSparseIndex::At");
+
+					return this->Find(id);
 				}
-			}
 
-			[[nodiscard]] std::optional<std::reference_wrapper<const ElementType>> GetIfExists(IDType id) const
-			{
-				if (this->Exists(id))
+				[[nodiscard]] IndexType Slot(std::size_t id) const
 				{
-					return std::optional<std::reference_wrapper<const ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.at(id)))};
+					assert(id < this->Size() && m_Pages[id >> PageShift]);
+					return m_Pages[id >> PageShift]->Slots[id & PageMask];
 				}
-				else
+
+				void Set(std::size_t id, IndexType index)
 				{
-					return std::nullopt;
+					if (id >= this->Size())
+						throw std::out_of_range("PagedSparseIndex::Set");
+
+					this->SetUnchecked(id, index);
 				}
-			}
 
-			[[nodiscard]] std::vector<ElementType>& GetData() { return m_Elements; }
+				void SetUnchecked(std::size_t id, IndexType index)
+				{
+					assert(id < this->Size());
+					Page*& page = m_Pages[id >> PageShift];
+					if (!page)
+					{
+						if (index == Empty)
+							return;
 
-			[[nodiscard]] const std::vector<ElementType>& GetData() const { return m_Elements; }
+						page = this->AllocatePage();
+					}
 
-			[[nodiscard]] bool Exists(IDType id) const
-			{
-				if (id >= m_ID_To_Element.size())
-					return false;
+					IndexType& slot = page->Slots[id & PageMask];
+					if (slot == Empty && index != Empty)
+					{
+						page->NumLive++;
+					}
+					else if (slot != Empty && index == Empty)
+					{
+						page->NumLive--;
+					}
+					slot = index;
 
-				const IDType elementIndex = m_ID_To_Element.at(id);
-				return elementIndex != InvalidIndex;
-			}
+					if (page->NumLive == 0)
+					{
+						this->DeallocatePage(page);
+						page = nullptr;
+					}
+				}
 
-			void ShrinkToFit()
-			{
-				m_Elements.resize(m_CurrentLast);
-				m_Elements.shrink_to_fit();
-				m_Element_To_ID.resize(m_CurrentLast);
-				m_Element_To_ID.shrink_to_fit();
-			}
+				void Resize(std::size_t numIDs)
+				{
+					const std::size_t numPages = (numIDs + PageMask) >> PageShift;
+					if (numPages > m_Pages.size())
+					{
+						m_Pages.resize(numPages, nullptr);
+					}
+				}
 
-			void Reserve(IDType numEntries)
-			{
-				if (numEntries > m_ID_To_Element.size())
+				// Releases the pages and page table entries past the page holding numIDs - 1, they have to be empty.
+				void Truncate(std::size_t numIDs)
 				{
-					m_ID_To_Element.resize(numEntries, InvalidIndex);
+					const std::size_t numPages = (numIDs + PageMask) >> PageShift;
+					if (numPages < m_Pages.size())
+					{
+						for (std::size_t i = numPages; i < m_Pages.size(); i++)
+						{
+							if (m_Pages[i])
+							{
+								this->DeallocatePage(m_Pages[i]);
+							}
+						}
+						m_Pages.resize(numPages);
+						m_Pages.shrink_to_fit();
+					}
 				}
-			}
 
-			[[nodiscard]] std::size_t NumSupportedElements() const
+				[[nodiscard]] std::size_t Size() const { return m_Pages.size() << PageShift; }
+
+				[[nodiscard]] std::size_t NumAllocatedPages() const
+				{
+					return static_cast<std::size_t>(std::count_if(m_Pages.begin(), m_Pages.end(), [](const Page* page) { return page != nullptr; }));
+				}
+
+				[[nodiscard]] std::size_t ReservedBytes() const
+				{
+					return m_Pages.capacity() * sizeof(Page*) + this->NumAllocatedPages() * sizeof(Page);
+				}
+
+			private:
+				using PageTableAllocator = RebindAllocator<Allocator, Page*>;
+
+				[[nodiscard]] Page* AllocatePage(const Page* source = nullptr)
+				{
+					Page* page = PageAllocatorTraits::allocate(m_PageAllocator, 1);
+					PageAllocatorTraits::construct(m_PageAllocator, page);
+					if (source)
+					{
+						*page = *source;
+					}
+					else
+					{
+						std::fill(std::begin(page->Slots), std::end(page->Slots), Empty);
+					}
+					return page;
+				}
+
+				void DeallocatePage(Page* page)
+				{
+					PageAllocatorTraits::destroy(m_PageAllocator, page);
+					PageAllocatorTraits::deallocate(m_PageAllocator, page, 1);
+				}
+
+				// Expects m_Pages to hold the page table of other, replaces every entry with a copy owned by this index.
+				void CopyPages(const PagedSparseIndex& other)
+				{
+					m_Pages.resize(other.m_Pages.size());
+					for (std::size_t i = 0; i < other.m_Pages.size(); i++)
+					{
+						m_Pages[i] = other.m_Pages[i] ? this->AllocatePage(other.m_Pages[i]) : nullptr;
+					}
+				}
+
+				void FreePages()
+				{
+					for (Page*& page : m_Pages)
+					{
+						if (page)
+						{
+							this->DeallocatePage(page);
+							page = nullptr;
+						}
+					}
+				}
+
+				std::vector<Page*, PageTableAllocator> m_Pages;
+				PageAllocator m_PageAllocator;
+			};
+
+			template<UnsignedInteger IndexType, std::size_t PageSize, typename Allocator>
+			struct SelectSparseIndex
 			{
-				return m_ID_To_Element.size();
-			}
+				using Type = PagedSparseIndex<IndexType, PageSize, Allocator>;
+			};
 
-			[[nodiscard]] std::size_t InternalSize() const
+			template<UnsignedInteger IndexType, typename Allocator>
+			struct SelectSparseIndex<IndexType, 0, Allocator>
 			{
-				return m_Elements.capacity();
-			}
+				using Type = FlatSparseIndex<IndexType, Allocator>;
+			};
 
-			[[nodiscard]] IDType GetElementIndex(IDType id) const { return m_ID_To_Element.at(id); }
+			// Returns a mask with bit i set if ids[i] < numSlots and slots[ids[i]] isn't empty, for up to 64 ids.
+			// 32 and 64 bit slots are gathered with AVX-512 or AVX2 when the build targets them, everything else runs the scalar loop.
+			template<UnsignedInteger Slot>
+			[[nodiscard]] std::uint64_t ExistsWord(const Slot* slots, std::size_t numSlots, const Slot* ids, std::size_t count)
+			{
+				constexpr Slot Empty = std::numeric_limits<Slot>::max();
+				std::uint64_t word = 0;
+				std::size_t i = 0;
+
+				if (numSlots == 0)
+					return 0;
+
+#if defined(__AVX512F__)
+				if constexpr (sizeof(Slot) == 4)
+				{
+					if (numSlots <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+					{
+						const __m512i size = _mm512_set1_epi32(static_cast<std::int32_t>(numSlots));
+						const __m512i empty = _mm512_set1_epi32(-1);
+						for (; i + 16 <= count; i += 16)
+						{
+							const __m512i lanes = _mm512_loadu_si512(ids + i);
+							const __mmask16 inRange = _mm512_cmplt_epu32_mask(lanes, size);
+							const __m512i found = _mm512_mask_i32gather_epi32(empty, inRange, lanes, slots, 4);
+							const __mmask16 present = _mm512_mask_cmpneq_epi32_mask(inRange, found, empty);
+							word |= static_cast<std::uint64_t>(present) << i;
+						}
+					}
+				}
+				else if constexpr (sizeof(Slot) == 8)
+				{
+					const __m512i size = _mm512_set1_epi64(static_cast<long long>(numSlots));
+					const __m512i empty = _mm512_set1_epi64(-1);
+					for (; i + 8 <= count; i += 8)
+					{
+						const __m512i lanes = _mm512_loadu_si512(ids + i);
+						const __mmask8 inRange = _mm512_cmplt_epu64_mask(lanes, size);
+						const __m512i found = _mm512_mask_i64gather_epi64(empty, inRange, lanes, slots, 8);
+						const __mmask8 present = _mm512_mask_cmpneq_epi64_mask(inRange, found, empty);
+						word |= static_cast<std::uint64_t>(present) << i;
+					}
+				}
+#elif defined(__AVX2__)
+				if constexpr (sizeof(Slot) == 4)
+				{
+					if (numSlots <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+					{
+						const __m256i last = _mm256_set1_epi32(static_cast<std::int32_t>(numSlots - 1));
+						const __m256i empty = _mm256_set1_epi32(-1);
+						for (; i + 8 <= count; i += 8)
+						{
+							const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + i));
+							const __m256i inRange = _mm256_cmpeq_epi32(_mm256_min_epu32(lanes, last), lanes);
+							const __m256i found = _mm256_mask_i32gather_epi32(empty, reinterpret_cast<const int*>(slots), lanes, inRange, 4);
+							const __m256i present = _mm256_andnot_si256(_mm256_cmpeq_epi32(found, empty), inRange);
+							word |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(present)))) << i;
+						}
+					}
+				}
+				else if constexpr (sizeof(Slot) == 8)
+				{
+					const __m256i signBit = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+					const __m256i size = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(numSlots)), signBit);
+					const __m256i empty = _mm256_set1_epi64x(-1);
+					for (; i + 4 <= count; i += 4)
+					{
+						const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + i));
+						const __m256i inRange = _mm256_cmpgt_epi64(size, _mm256_xor_si256(lanes, signBit));
+						const __m256i found = _mm256_mask_i64gather_epi64(empty, reinterpret_cast<const long long*>(slots), lanes, inRange, 8);
+						const __m256i present = _mm256_andnot_si256(_mm256_cmpeq_epi64(found, empty), inRange);
+						word |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(present)))) << i;
+					}
+				}
+#endif
+
+				for (; i < count; i++)
+				{
+					const bool present = ids[i] < numSlots && slots[ids[i]] != Empty;
+					word |= static_cast<std::uint64_t>(present) << i;
+				}
+				return word;
+			}
+
+			template<typename Config, UnsignedInteger IDType>
+			inline constexpr std::size_t EffectiveMaxID = std::min<std::size_t>({ Config::MaxID, VersionedIDTraits<IDType, Config::VersionBits>::IndexMask, std::numeric_limits<std::size_t>::max() - 1 });
+
+			// Throws std::length_error or asserts, depending on Config::IndexOverflow, if Size() would grow past MaxElements dense indices.
+			template<typename Config, std::size_t MaxElements>
+			void CheckCapacity([[maybe_unused]] std::size_t required, [[maybe_unused]] const char* message)
+			{
+				if constexpr (Config::IndexOverflow == IndexOverflowPolicy::Throw)
+				{
+					if (required > MaxElements)
+						throw std::length_error(message);
+				}
+				else
+				{
+					assert(required <= MaxElements);
+				}
+			}
+
+			// Makes id addressable in the sparse index. Grows it when Config::GrowOnInsert is set, otherwise a checked config throws.
+			template<typename Config, bool Checked, std::size_t MaxID, typename SparseIndex>
+			void PrepareSparseSlot(SparseIndex& sparseIndex, std::size_t id)
+			{
+				static_assert(Config::SparseGrowthFactor > 1.0, "SparseGrowthFactor has to be larger than 1");
+
+				if (id < sparseIndex.Size())
+					return;
+
+				if constexpr (Config::GrowOnInsert)
+				{
+					if (id > MaxID)
+						throw std::out_of_range("SparseSet::Insert: ID exceeds MaxID");
+
+					const std::size_t required = id + 1;
+					const std::size_t grown = static_cast<std::size_t>(static_cast<double>(sparseIndex.Size()) * Config::SparseGrowthFactor);
+					sparseIndex.Resize(std::min(std::max(required, grown), MaxID + 1));
+				}
+				else if constexpr (Checked)
+				{
+					throw std::out_of_range("SparseSet::Insert");
+				}
+			}
+		}
+
+		// Leads the binary format written by SparseSet::Serialize. The ID and element blocks follow at 64 byte aligned offsets from the start of the header.
+		// An optional third block holds the encoded sparse slots of indices [0, NumSparseSlots) so that SparseSetView can serve lookups from a mapped file without rebuilding them.
+		struct SparseSetFileHeader
+		{
+			static constexpr std::uint32_t MagicValue = 0x5353415A; // "ZASS" read as little endian bytes
+			static constexpr std::uint16_t CurrentFormat = 1;
+			static constexpr std::size_t BlockAlignment = 64;
+
+			std::uint32_t Magic = MagicValue;
+			std::uint16_t Format = CurrentFormat;
+			std::uint8_t IDSize = 0;
+			std::uint8_t VersionBits = 0;
+			std::uint8_t LittleEndian = std::endian::native == std::endian::little;
+			std::uint8_t SlotSize = 0;
+			std::uint8_t Reserved[2] = {};
+			std::uint32_t ElementSize = 0;
+			std::uint64_t Count = 0;
+			std::uint64_t IDsOffset = 0;
+			std::uint64_t ElementsOffset = 0;
+			std::uint64_t SparseOffset = 0;
+			std::uint64_t NumSparseSlots = 0;
+
+			[[nodiscard]] static constexpr std::uint64_t AlignBlock(std::uint64_t offset)
+			{
+				return (offset + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+			}
+
+			// Fills in the layout fields and block offsets for count IDType IDs and ElementType elements, and numSparseSlots SlotType slots.
+			template<UnsignedInteger IDType, typename ElementType, UnsignedInteger SlotType = IDType>
+			void Describe(unsigned versionBits, std::uint64_t count, std::uint64_t numSparseSlots)
+			{
+				IDSize = sizeof(IDType);
+				SlotSize = sizeof(SlotType);
+				VersionBits = static_cast<std::uint8_t>(versionBits);
+				ElementSize = static_cast<std::uint32_t>(sizeof(ElementType));
+				Count = count;
+				IDsOffset = AlignBlock(sizeof(SparseSetFileHeader));
+				ElementsOffset = AlignBlock(IDsOffset + count * sizeof(IDType));
+				NumSparseSlots = numSparseSlots;
+				SparseOffset = numSparseSlots == 0 ? 0 : AlignBlock(ElementsOffset + count * sizeof(ElementType));
+			}
+
+			// True if the header was written for the same ID and element layout on a machine of the same endianness, with blocks whose offsets don't overflow.
+			template<UnsignedInteger IDType, typename ElementType, UnsignedInteger SlotType = IDType>
+			[[nodiscard]] bool Matches(unsigned versionBits) const
+			{
+				// Block sizes that wrap around would yield offsets, and an End(), that fit a buffer far smaller than the blocks
+				constexpr std::uint64_t maxBlockBytes = std::numeric_limits<std::uint64_t>::max() - 4 * BlockAlignment;
+				constexpr std::uint64_t entryBytes = sizeof(IDType) + sizeof(ElementType);
+				if (Count > maxBlockBytes / entryBytes || NumSparseSlots > (maxBlockBytes - Count * entryBytes) / sizeof(SlotType))
+					return false;
+
+				SparseSetFileHeader expected;
+				expected.Describe<IDType, ElementType, SlotType>(versionBits, Count, NumSparseSlots);
+				return Magic == MagicValue &&
+					Format == CurrentFormat &&
+					LittleEndian == expected.LittleEndian &&
+					IDSize == expected.IDSize &&
+					SlotSize == expected.SlotSize &&
+					VersionBits == expected.VersionBits &&
+					ElementSize == expected.ElementSize &&
+					Count <= std::numeric_limits<IDType>::max() &&
+					(NumSparseSlots == 0 || NumSparseSlots - 1 <= std::numeric_limits<IDType>::max()) &&
+					IDsOffset == expected.IDsOffset &&
+					ElementsOffset == expected.ElementsOffset &&
+					SparseOffset == expected.SparseOffset;
+			}
+
+			// Offset one past the last block.
+			template<UnsignedInteger IDType, typename ElementType, UnsignedInteger SlotType = IDType>
+			[[nodiscard]] std::uint64_t End() const
+			{
+				return NumSparseSlots == 0 ? ElementsOffset + Count * sizeof(ElementType) : SparseOffset + NumSparseSlots * sizeof(SlotType);
+			}
+		};
+
+		// Leads a delta written by SparseSet::WriteDelta. The blocks follow back to back:
+		// NumErased IDs, NumAssigned IDs and elements that replace or insert, then NumXored IDs and elements stored as XOR against the receiver's current element.
+		struct SparseSetDeltaHeader
+		{
+			static constexpr std::uint32_t MagicValue = 0x4453415A; // "ZASD" read as little endian bytes
+			static constexpr std::uint16_t CurrentFormat = 1;
+
+			std::uint32_t Magic = MagicValue;
+			std::uint16_t Format = CurrentFormat;
+			std::uint8_t IDSize = 0;
+			std::uint8_t VersionBits = 0;
+			std::uint8_t LittleEndian = std::endian::native == std::endian::little;
+			std::uint8_t Reserved[3] = {};
+			std::uint32_t ElementSize = 0;
+			std::uint64_t BaselineVersion = 0;
+			std::uint64_t Version = 0;
+			std::uint64_t NumErased = 0;
+			std::uint64_t NumAssigned = 0;
+			std::uint64_t NumXored = 0;
+		};
+
+		// Receives the IDs that enter or leave a SparseSet. OnErasing is called before the element is removed.
+		template<UnsignedInteger IDType>
+		class SparseSetObserver
+		{
+		public:
+			virtual ~SparseSetObserver() = default;
+
+			virtual void OnInserted(IDType id) = 0;
+			virtual void OnErasing(IDType id) = 0;
+		};
+
+		namespace detail
+		{
+			// hardware_concurrency() - 1 std::thread workers, started on first use and kept until exit so that per frame parallel calls don't pay for thread startup.
+			// One call runs at a time. A call made while the pool is busy, including from inside a chunk, runs on the calling thread alone.
+			class ParallelWorkerPool
+			{
+			public:
+				[[nodiscard]] static ParallelWorkerPool& Instance()
+				{
+					static ParallelWorkerPool pool(std::max<unsigned>(std::thread::hardware_concurrency(), 1) - 1);
+					return pool;
+				}
+
+				ParallelWorkerPool(const ParallelWorkerPool&) = delete;
+				ParallelWorkerPool& operator=(const ParallelWorkerPool&) = delete;
+
+				~ParallelWorkerPool()
+				{
+					{
+						std::lock_guard<std::mutex> lock(m_Mutex);
+						m_Stop = true;
+					}
+					m_Wake.notify_all();
+					for (std::thread& worker : m_Workers)
+					{
+						worker.join();
+					}
+				}
+
+				// Calls work() on the calling thread and on up to maxHelpers workers, and returns once every call has returned.
+				// work has to be safe to call concurrently and is expected to share its items through a counter, so any subset of the calls covers all of them.
+				// The first exception of any call is rethrown once all of them are done.
+				template<typename Work>
+				void Run(std::size_t maxHelpers, Work& work)
+				{
+					const std::size_t numHelpers = std::min(maxHelpers, m_Workers.size());
+					if (numHelpers == 0 || m_Busy.exchange(true, std::memory_order_acquire))
+					{
+						work();
+						return;
+					}
+
+					{
+						std::lock_guard<std::mutex> lock(m_Mutex);
+						m_Job = static_cast<void*>(&work);
+						m_Invoke = [](void* job) { (*static_cast<Work*>(job))(); };
+						m_NumHelpers = numHelpers;
+						m_NumClaimed = 0;
+						m_NumRunning = numHelpers;
+						m_Exception = nullptr;
+						m_Generation++;
+					}
+					m_Wake.notify_all();
+
+					// The helpers reference work, so they have to finish before an exception leaves this frame
+					std::exception_ptr exception;
+					try
+					{
+						work();
+					}
+					catch (...)
+					{
+						exception = std::current_exception();
+					}
+
+					{
+						std::unique_lock<std::mutex> lock(m_Mutex);
+						m_Done.wait(lock, [this] { return m_NumRunning == 0; });
+						if (!exception)
+						{
+							exception = std::exchange(m_Exception, nullptr);
+						}
+					}
+					m_Busy.store(false, std::memory_order_release);
+					if (exception)
+						std::rethrow_exception(exception);
+				}
+
+			private:
+				explicit ParallelWorkerPool(std::size_t numWorkers)
+				{
+					m_Workers.reserve(numWorkers);
+					for (std::size_t i = 0; i < numWorkers; i++)
+					{
+						try
+						{
+							m_Workers.emplace_back([this] { this->WorkerLoop(); });
+						}
+						catch (const std::system_error&)
+						{
+							break; // The workers that did start and the calling thread still cover every item
+						}
+					}
+				}
+
+				void WorkerLoop()
+				{
+					std::uint64_t seenGeneration = 0;
+					std::unique_lock<std::mutex> lock(m_Mutex);
+					for (;;)
+					{
+						m_Wake.wait(lock, [&] { return m_Stop || (m_Generation != seenGeneration && m_NumClaimed < m_NumHelpers); });
+						if (m_Stop)
+							return;
+
+						seenGeneration = m_Generation;
+						m_NumClaimed++;
+						void* const job = m_Job;
+						void (*const invoke)(void*) = m_Invoke;
+						lock.unlock();
+						std::exception_ptr exception;
+						try
+						{
+							invoke(job);
+						}
+						catch (...)
+						{
+							exception = std::current_exception();
+						}
+						lock.lock();
+						if (exception && !m_Exception)
+						{
+							m_Exception = exception;
+						}
+						if (--m_NumRunning == 0)
+						{
+							m_Done.notify_one();
+						}
+					}
+				}
+
+				std::atomic<bool> m_Busy = false;
+				std::mutex m_Mutex;
+				std::condition_variable m_Wake;
+				std::condition_variable m_Done;
+				void* m_Job = nullptr;
+				void (*m_Invoke)(void*) = nullptr;
+				std::size_t m_NumHelpers = 0;
+				std::size_t m_NumClaimed = 0;
+				std::size_t m_NumRunning = 0;
+				std::exception_ptr m_Exception;
+				std::uint64_t m_Generation = 0;
+				bool m_Stop = false;
+				std::vector<std::thread> m_Workers;
+			};
+		}
+
+		// Runs runChunk(i) for every i in [0, numChunks) and returns once all of them are done.
+		// Any type with the same call operator can be passed to ParallelForEach instead, for example to hand the chunks to a job system.
+		// Without AZERO_SPARSE_SET_PARALLEL_STL the calling thread and the workers of detail::ParallelWorkerPool take chunks from a shared counter.
+		struct StdParallelExecutor
+		{
+			template<typename ChunkFunc>
+			void operator()(std::size_t numChunks, ChunkFunc&& runChunk) const
+			{
+#if AZERO_SPARSE_SET_PARALLEL_STL
+				std::vector<std::size_t> chunks(numChunks);
+				std::iota(chunks.begin(), chunks.end(), std::size_t(0));
+				std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&runChunk](std::size_t chunk) { runChunk(chunk); });
+#else
+				std::atomic<std::size_t> next = 0;
+				auto work = [&]()
+					{
+						for (std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed); chunk < numChunks; chunk = next.fetch_add(1, std::memory_order_relaxed))
+						{
+							runChunk(chunk);
+						}
+					};
+
+				if (numChunks > 1)
+				{
+					detail::ParallelWorkerPool::Instance().Run(numChunks - 1, work);
+				}
+				else
+				{
+					work();
+				}
+#endif
+			}
+		};
+
+		namespace detail
+		{
+			inline constexpr std::size_t CacheLineSize = 64;
+
+			inline void Prefetch(const void* address)
+			{
+#if defined(__GNUC__) || defined(__clang__)
+				__builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+				_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+				(void)address;
+#endif
+			}
+
+			// Swaps two objects, bytewise for trivially relocatable types.
+			template<typename T>
+			void SwapElements(T& lhs, T& rhs)
+			{
+				if constexpr (IsTriviallyRelocatable<T>::value && !std::is_trivially_copyable_v<T>)
+				{
+					alignas(T) std::byte buffer[sizeof(T)];
+					std::memcpy(static_cast<void*>(buffer), static_cast<const void*>(std::addressof(lhs)), sizeof(T));
+					std::memcpy(static_cast<void*>(std::addressof(lhs)), static_cast<const void*>(std::addressof(rhs)), sizeof(T));
+					std::memcpy(static_cast<void*>(std::addressof(rhs)), static_cast<const void*>(buffer), sizeof(T));
+				}
+				else
+				{
+					using std::swap;
+					swap(lhs, rhs);
+				}
+			}
+
+			template<IsTriviallyCopyable T>
+			[[nodiscard]] T XorBytes(const T& lhs, const T& rhs)
+			{
+				unsigned char bytes[sizeof(T)];
+				unsigned char rhsBytes[sizeof(T)];
+				std::memcpy(bytes, &lhs, sizeof(T));
+				std::memcpy(rhsBytes, &rhs, sizeof(T));
+				for (std::size_t i = 0; i < sizeof(T); i++)
+				{
+					bytes[i] ^= rhsBytes[i];
+				}
+
+				T result = lhs;
+				std::memcpy(&result, bytes, sizeof(T));
+				return result;
+			}
+
+			// Fills block with count elements from reader, growing it one chunk per read so that a bogus count fails on the missing bytes instead of allocating all of it up front.
+			template<typename Reader, typename Vector>
+			[[nodiscard]] bool ReadBlock(Reader& reader, Vector& block, std::uint64_t count)
+			{
+				using T = typename Vector::value_type;
+				constexpr std::size_t ChunkElements = std::max<std::size_t>(64 * 1024 / sizeof(T), 1);
+
+				block.clear();
+				while (block.size() < count)
+				{
+					const std::size_t first = block.size();
+					const std::size_t num = static_cast<std::size_t>(std::min<std::uint64_t>(ChunkElements, count - first));
+					block.resize(first + num);
+					if (!reader(static_cast<void*>(block.data() + first), num * sizeof(T)))
+						return false;
+				}
+				return true;
+			}
+
+			// Splits [0, count) of an array into chunks whose inner boundaries start a cache line, so that no two chunks write to the same line.
+			// Chunk 0 also takes the elements before the first line aligned element. Every other chunk spans a whole number of lines.
+			struct ParallelChunking
+			{
+				std::size_t Head = 0;
+				std::size_t Stride = 0;
+				std::size_t Count = 0;
+				std::size_t NumChunks = 0;
+
+				ParallelChunking(const void* data, std::size_t elementSize, std::size_t count, std::size_t minChunkBytes)
+					:Count(count)
+				{
+					if (count == 0)
+						return;
+
+					const std::size_t lineElements = CacheLineSize / std::gcd(elementSize, CacheLineSize);
+					const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+					for (std::size_t i = 0; i < lineElements; i++)
+					{
+						if ((address + i * elementSize) % CacheLineSize == 0)
+						{
+							Head = i;
+							break;
+						}
+					}
+
+					const std::size_t numWorkers = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+					const std::size_t byBytes = (minChunkBytes + elementSize - 1) / elementSize;
+					const std::size_t byWorkers = (count + numWorkers * 4 - 1) / (numWorkers * 4);
+					Stride = (std::max({ byBytes, byWorkers, std::size_t(1) }) + lineElements - 1) / lineElements * lineElements;
+					NumChunks = count > Head ? (count - Head + Stride - 1) / Stride : 1;
+				}
+
+				[[nodiscard]] std::size_t Begin(std::size_t chunk) const
+				{
+					return chunk == 0 ? 0 : std::min(Count, Head + chunk * Stride);
+				}
+
+				[[nodiscard]] std::size_t End(std::size_t chunk) const { return this->Begin(chunk + 1); }
+			};
+
+			// The observer belongs to one set instance, copies and moves of the set start out unobserved.
+			template<UnsignedInteger IDType>
+			class ObserverSlot
+			{
+			public:
+				ObserverSlot() = default;
+				ObserverSlot(const ObserverSlot&) { }
+				ObserverSlot& operator=(const ObserverSlot&) { return *this; }
+
+				SparseSetObserver<IDType>* Observer = nullptr;
+			};
+
+			// One bit per ID index, plus a summary bit per 64 bit word that is set while the word isn't zero.
+			// Ordered walks skip empty 4096 ID ranges with one summary test. The disabled specialization is empty.
+			// Paged keeps the 64 words under each summary word in their own page, allocated on the first set bit and freed once the summary word is zero again.
+			template<typename Allocator, bool Enabled, bool Paged = false>
+			class OccupancyBitset
+			{
+			public:
+				OccupancyBitset() = default;
+				explicit OccupancyBitset(const Allocator&) { }
+
+				void Assign(std::size_t, bool) { }
+				void ShrinkToFit() { }
+
+				[[nodiscard]] std::size_t ReservedBytes() const { return 0; }
+			};
+
+			template<typename Allocator>
+			class OccupancyBitset<Allocator, true, false>
+			{
+			public:
+				OccupancyBitset() = default;
+
+				explicit OccupancyBitset(const Allocator& allocator)
+					:m_Words(allocator), m_Summary(allocator){ }
+
+				void Assign(std::size_t index, bool occupied)
+				{
+					const std::size_t wordIndex = index / 64;
+					const std::uint64_t bit = std::uint64_t(1) << (index % 64);
+					if (occupied)
+					{
+						if (wordIndex >= m_Words.size())
+						{
+							m_Words.resize(wordIndex + 1, 0);
+							m_Summary.resize(wordIndex / 64 + 1, 0);
+						}
+						m_Words[wordIndex] |= bit;
+						m_Summary[wordIndex / 64] |= std::uint64_t(1) << (wordIndex % 64);
+					}
+					else if (wordIndex < m_Words.size())
+					{
+						m_Words[wordIndex] &= ~bit;
+						if (m_Words[wordIndex] == 0)
+						{
+							m_Summary[wordIndex / 64] &= ~(std::uint64_t(1) << (wordIndex % 64));
+						}
+					}
+				}
+
+				[[nodiscard]] bool Test(std::size_t index) const
+				{
+					return index / 64 < m_Words.size() && (m_Words[index / 64] >> (index % 64)) & 1;
+				}
+
+				// Calls visit(index) for every set bit in ascending order.
+				template<typename Visit>
+				void ForEach(Visit&& visit) const
+				{
+					for (std::size_t summaryIndex = 0; summaryIndex < m_Summary.size(); summaryIndex++)
+					{
+						for (std::uint64_t summary = m_Summary[summaryIndex]; summary != 0; summary &= summary - 1)
+						{
+							const std::size_t wordIndex = summaryIndex * 64 + static_cast<std::size_t>(std::countr_zero(summary));
+							for (std::uint64_t word = m_Words[wordIndex]; word != 0; word &= word - 1)
+							{
+								visit(wordIndex * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+							}
+						}
+					}
+				}
+
+				// One past the highest set bit, 0 if no bit is set.
+				[[nodiscard]] std::size_t Extent() const
+				{
+					for (std::size_t summaryIndex = m_Summary.size(); summaryIndex-- > 0;)
+					{
+						if (m_Summary[summaryIndex] != 0)
+						{
+							const std::size_t wordIndex = summaryIndex * 64 + 63 - static_cast<std::size_t>(std::countl_zero(m_Summary[summaryIndex]));
+							return wordIndex * 64 + 64 - static_cast<std::size_t>(std::countl_zero(m_Words[wordIndex]));
+						}
+					}
+					return 0;
+				}
+
+				// Drops the words above the highest set bit.
+				void ShrinkToFit()
+				{
+					const std::size_t numWords = (this->Extent() + 63) / 64;
+					m_Words.resize(numWords);
+					m_Words.shrink_to_fit();
+					m_Summary.resize((numWords + 63) / 64);
+					m_Summary.shrink_to_fit();
+				}
+
+				[[nodiscard]] std::uint64_t Word(std::size_t wordIndex) const { return wordIndex < m_Words.size() ? m_Words[wordIndex] : 0; }
+				[[nodiscard]] std::size_t NumWords() const { return m_Words.size(); }
+
+				[[nodiscard]] std::span<const std::uint64_t> Words() const { return m_Words; }
+				[[nodiscard]] std::span<const std::uint64_t> Summary() const { return m_Summary; }
+
+				[[nodiscard]] std::size_t ReservedBytes() const { return (m_Words.capacity() + m_Summary.capacity()) * sizeof(std::uint64_t); }
+
+			private:
+				std::vector<std::uint64_t, RebindAllocator<Allocator, std::uint64_t>> m_Words;
+				std::vector<std::uint64_t, RebindAllocator<Allocator, std::uint64_t>> m_Summary;
+			};
+
+			template<typename Allocator>
+			class OccupancyBitset<Allocator, true, true>
+			{
+				static constexpr std::size_t PageWords = 64;
+
+				using WordVector = std::vector<std::uint64_t, RebindAllocator<Allocator, std::uint64_t>>;
+
+			public:
+				OccupancyBitset() = default;
+
+				explicit OccupancyBitset(const Allocator& allocator)
+					:m_Pages(allocator), m_Summary(allocator){ }
+
+				void Assign(std::size_t index, bool occupied)
+				{
+					const std::size_t wordIndex = index / 64;
+					const std::size_t pageIndex = wordIndex / PageWords;
+					const std::uint64_t bit = std::uint64_t(1) << (index % 64);
+					const std::uint64_t summaryBit = std::uint64_t(1) << (wordIndex % PageWords);
+					if (occupied)
+					{
+						if (pageIndex >= m_Pages.size())
+						{
+							m_Pages.resize(pageIndex + 1, WordVector(m_Summary.get_allocator()));
+							m_Summary.resize(pageIndex + 1, 0);
+						}
+
+						WordVector& page = m_Pages[pageIndex];
+						if (page.empty())
+						{
+							page.assign(PageWords, 0);
+						}
+						page[wordIndex % PageWords] |= bit;
+						m_Summary[pageIndex] |= summaryBit;
+					}
+					else if (pageIndex < m_Pages.size() && !m_Pages[pageIndex].empty())
+					{
+						WordVector& page = m_Pages[pageIndex];
+						page[wordIndex % PageWords] &= ~bit;
+						if (page[wordIndex % PageWords] == 0)
+						{
+							m_Summary[pageIndex] &= ~summaryBit;
+							if (m_Summary[pageIndex] == 0)
+							{
+								page = WordVector(page.get_allocator());
+							}
+						}
+					}
+				}
+
+				[[nodiscard]] bool Test(std::size_t index) const
+				{
+					return (this->Word(index / 64) >> (index % 64)) & 1;
+				}
+
+				// Calls visit(index) for every set bit in ascending order.
+				template<typename Visit>
+				void ForEach(Visit&& visit) const
+				{
+					for (std::size_t pageIndex = 0; pageIndex < m_Summary.size(); pageIndex++)
+					{
+						for (std::uint64_t summary = m_Summary[pageIndex]; summary != 0; summary &= summary - 1)
+						{
+							const std::size_t pageWord = static_cast<std::size_t>(std::countr_zero(summary));
+							const std::size_t wordIndex = pageIndex * PageWords + pageWord;
+							for (std::uint64_t word = m_Pages[pageIndex][pageWord]; word != 0; word &= word - 1)
+							{
+								visit(wordIndex * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+							}
+						}
+					}
+				}
+
+				// One past the highest set bit, 0 if no bit is set.
+				[[nodiscard]] std::size_t Extent() const
+				{
+					for (std::size_t pageIndex = m_Summary.size(); pageIndex-- > 0;)
+					{
+						if (m_Summary[pageIndex] != 0)
+						{
+							const std::size_t pageWord = 63 - static_cast<std::size_t>(std::countl_zero(m_Summary[pageIndex]));
+							const std::size_t wordIndex = pageIndex * PageWords + pageWord;
+							return wordIndex * 64 + 64 - static_cast<std::size_t>(std::countl_zero(m_Pages[pageIndex][pageWord]));
+						}
+					}
+					return 0;
+				}
+
+				// Drops the page slots above the highest set bit, empty pages are already freed.
+				void ShrinkToFit()
+				{
+					const std::size_t numPages = (this->Extent() + PageWords * 64 - 1) / (PageWords * 64);
+					m_Pages.resize(numPages);
+					m_Pages.shrink_to_fit();
+					m_Summary.resize(numPages);
+					m_Summary.shrink_to_fit();
+				}
+
+				[[nodiscard]] std::uint64_t Word(std::size_t wordIndex) const
+				{
+					const std::size_t pageIndex = wordIndex / PageWords;
+					return pageIndex < m_Pages.size() && !m_Pages[pageIndex].empty() ? m_Pages[pageIndex][wordIndex % PageWords] : 0;
+				}
+
+				[[nodiscard]] std::size_t NumWords() const { return m_Pages.size() * PageWords; }
+
+				[[nodiscard]] std::span<const std::uint64_t> Summary() const { return m_Summary; }
+
+				[[nodiscard]] std::size_t ReservedBytes() const
+				{
+					std::size_t bytes = m_Pages.capacity() * sizeof(WordVector) + m_Summary.capacity() * sizeof(std::uint64_t);
+					for (const WordVector& page : m_Pages)
+					{
+						bytes += page.capacity() * sizeof(std::uint64_t);
+					}
+					return bytes;
+				}
+
+			private:
+				std::vector<WordVector, RebindAllocator<Allocator, WordVector>> m_Pages;
+				WordVector m_Summary;
+			};
+
+			// Change state of a tracked SparseSet: one dirty bit per dense index plus the IDs added and removed since the last clear.
+			// The untracked specialization is empty and every hook compiles away.
+			template<UnsignedInteger IDType, typename Allocator, bool Enabled>
+			class ChangeTracker
+			{
+			public:
+				ChangeTracker() = default;
+				explicit ChangeTracker(const Allocator&) { }
+
+				void OnInserted(IDType, std::size_t) { }
+				void OnMoved(std::size_t, std::size_t) { }
+				void OnRemoved(IDType, std::size_t) { }
+				void OnSwapped(std::size_t, std::size_t) { }
+				void Mark(std::size_t) { }
+				void ShrinkToFit(std::size_t) { }
+
+				[[nodiscard]] std::size_t ReservedBytes() const { return 0; }
+			};
+
+			template<UnsignedInteger IDType, typename Allocator>
+			class ChangeTracker<IDType, Allocator, true>
+			{
+			public:
+				ChangeTracker() = default;
+
+				explicit ChangeTracker(const Allocator& allocator)
+					:m_Dirty(allocator), m_Added(allocator), m_Removed(allocator){ }
+
+				void OnInserted(IDType id, std::size_t elementIndex)
+				{
+					this->Mark(elementIndex);
+					m_Added.push_back(id);
+				}
+
+				// The element at from was moved to to and from is about to die, the dirty bit follows the element.
+				void OnMoved(std::size_t from, std::size_t to)
+				{
+					this->Assign(to, this->IsDirty(from));
+				}
+
+				void OnRemoved(IDType id, std::size_t lastIndex)
+				{
+					this->Assign(lastIndex, false);
+					m_Removed.push_back(id);
+					m_Version++;
+				}
+
+				void OnSwapped(std::size_t lhs, std::size_t rhs)
+				{
+					const bool lhsDirty = this->IsDirty(lhs);
+					this->Assign(lhs, this->IsDirty(rhs));
+					this->Assign(rhs, lhsDirty);
+				}
+
+				void Mark(std::size_t elementIndex)
+				{
+					if (elementIndex / 64 >= m_Dirty.size())
+					{
+						m_Dirty.resize(elementIndex / 64 + 1, 0);
+					}
+					m_Dirty[elementIndex / 64] |= std::uint64_t(1) << (elementIndex % 64);
+					m_Version++;
+				}
+
+				[[nodiscard]] bool IsDirty(std::size_t elementIndex) const
+				{
+					return elementIndex / 64 < m_Dirty.size() && (m_Dirty[elementIndex / 64] >> (elementIndex % 64)) & 1;
+				}
+
+				// Drops the dirty words past numElements, their bits are already clear since removals reset the bit of the vacated index.
+				void ShrinkToFit(std::size_t numElements)
+				{
+					m_Dirty.resize(std::min(m_Dirty.size(), (numElements + 63) / 64));
+					m_Dirty.shrink_to_fit();
+					m_Added.shrink_to_fit();
+					m_Removed.shrink_to_fit();
+				}
+
+				void Clear()
+				{
+					std::fill(m_Dirty.begin(), m_Dirty.end(), 0);
+					m_Added.clear();
+					m_Removed.clear();
+					m_ClearedVersion = m_Version;
+				}
+
+				[[nodiscard]] std::span<const std::uint64_t> DirtyWords() const { return m_Dirty; }
+				[[nodiscard]] std::span<const IDType> Added() const { return m_Added; }
+				[[nodiscard]] std::span<const IDType> Removed() const { return m_Removed; }
+				[[nodiscard]] std::uint64_t Version() const { return m_Version; }
+				[[nodiscard]] std::uint64_t ClearedVersion() const { return m_ClearedVersion; }
+
+				[[nodiscard]] std::size_t ReservedBytes() const
+				{
+					return m_Dirty.capacity() * sizeof(std::uint64_t) + (m_Added.capacity() + m_Removed.capacity()) * sizeof(IDType);
+				}
+
+			private:
+				void Assign(std::size_t elementIndex, bool dirty)
+				{
+					if (dirty)
+					{
+						this->Mark(elementIndex);
+					}
+					else if (elementIndex / 64 < m_Dirty.size())
+					{
+						m_Dirty[elementIndex / 64] &= ~(std::uint64_t(1) << (elementIndex % 64));
+					}
+				}
+
+				std::vector<std::uint64_t, RebindAllocator<Allocator, std::uint64_t>> m_Dirty;
+				std::vector<IDType, RebindAllocator<Allocator, IDType>> m_Added;
+				std::vector<IDType, RebindAllocator<Allocator, IDType>> m_Removed;
+				std::uint64_t m_Version = 0;
+				std::uint64_t m_ClearedVersion = 0;
+			};
+		}
+
+		// ElementType only has to be movable. Serialization and deltas need trivially copyable elements, InsertBatch needs copyable ones.
+		template<UnsignedInteger IDType, IsMovable ElementType, typename ConfigOrIndex = DefaultSparseSetConfig>
+		class SparseSet
+		{
+		public:
+			// The third template parameter is a config or, as shorthand for CompactIndexConfig, the unsigned type of the stored dense indices.
+			using ConfigType = typename detail::ResolveSparseSetConfig<ConfigOrIndex>::Type;
+
+			// Type of the dense indices kept in the sparse index, returned by GetElementIndex and taken by SwapAt.
+			using IndexType = detail::SparseIndexTypeOf<IDType, ConfigType>;
+
+		private:
+			using Config = ConfigType;
+
+			static_assert(UnsignedInteger<IndexType>, "Config::IndexType has to be void or an unsigned integer type");
+			static_assert(Config::VersionBits < std::numeric_limits<IndexType>::digits, "VersionBits has to leave room for the dense index in a sparse slot");
+
+			using SparseIndexType = typename detail::SelectSparseIndex<IndexType, Config::SparsePageSize, typename Config::Allocator>::Type;
+
+			template<typename T>
+			using DenseVector = std::vector<T, detail::RebindAllocator<typename Config::Allocator, T>>;
+
+			// A sparse slot holds the dense index in its low bits and, with VersionBits, the version of the stored ID above it.
+			static constexpr unsigned SlotIndexBits = std::numeric_limits<IndexType>::digits - Config::VersionBits;
+			static constexpr IndexType SlotIndexMask = Config::VersionBits == 0 ? std::numeric_limits<IndexType>::max() : static_cast<IndexType>((IndexType(1) << SlotIndexBits) - 1);
+			static constexpr IndexType EmptySlot = SparseIndexType::Empty;
+
+			template<bool IsConst>
+			class EachIterator
+			{
+				using ElementPointer = std::conditional_t<IsConst, const ElementType*, ElementType*>;
+				using ElementReference = std::conditional_t<IsConst, const ElementType&, ElementType&>;
+
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using difference_type = std::ptrdiff_t;
+				using value_type = std::pair<IDType, ElementReference>;
+				using reference = value_type;
+
+				EachIterator() = default;
+
+				EachIterator(const IDType* id, ElementPointer element)
+					:m_ID(id), m_Element(element){ }
+
+				[[nodiscard]] reference operator*() const { return { *m_ID, *m_Element }; }
+
+				EachIterator& operator++()
+				{
+					++m_ID;
+					++m_Element;
+					return *this;
+				}
+
+				EachIterator operator++(int)
+				{
+					EachIterator previous = *this;
+					++(*this);
+					return previous;
+				}
+
+				[[nodiscard]] bool operator==(const EachIterator& other) const { return m_ID == other.m_ID; }
+
+			private:
+				const IDType* m_ID = nullptr;
+				ElementPointer m_Element = nullptr;
+			};
+
+			template<bool IsConst>
+			class EachRange
+			{
+			public:
+				EachRange(EachIterator<IsConst> begin, EachIterator<IsConst> end)
+					:m_Begin(begin), m_End(end){ }
+
+				[[nodiscard]] EachIterator<IsConst> begin() const { return m_Begin; }
+				[[nodiscard]] EachIterator<IsConst> end() const { return m_End; }
+
+			private:
+				EachIterator<IsConst> m_Begin;
+				EachIterator<IsConst> m_End;
+			};
+
+		public:
+			using KeyType = IDType;
+			using ValueType = ElementType;
+			using AllocatorType = typename Config::Allocator;
+			using IDTraits = VersionedIDTraits<IDType, Config::VersionBits>;
+
+			static constexpr IndexType InvalidIndex{ std::numeric_limits<IndexType>::max() };
+			static constexpr bool IsPaged = Config::SparsePageSize != 0;
+			static constexpr bool IsChecked = Config::CheckedAccess;
+			static constexpr std::size_t MaxID = detail::EffectiveMaxID<Config, IDType>;
+			static constexpr bool IsVersioned = Config::VersionBits != 0;
+			static constexpr bool IsTracked = Config::TrackChanges;
+			static constexpr bool HasOccupancy = Config::OccupancyBits;
+
+			// Upper bound for Size(), set by IndexType. With VersionBits the dense index also has to fit next to the version in a sparse slot.
+			static constexpr std::size_t MaxElements = IsVersioned ? SlotIndexMask : InvalidIndex;
+
+			SparseSet() = default;
+
+			explicit SparseSet(const AllocatorType& allocator)
+				:m_ID_To_Element(allocator), m_Element_To_ID(allocator), m_Elements(allocator), m_Changes(allocator), m_Occupancy(allocator){ }
+
+			SparseSet(IDType numElements, const AllocatorType& allocator = AllocatorType())
+				:m_ID_To_Element(numElements, allocator), m_Element_To_ID(allocator), m_Elements(allocator), m_Changes(allocator), m_Occupancy(allocator){ }
+
+			// Returns false and leaves the present element untouched if id is already present.
+			// With VersionBits, an element stored under another version of the same index is stale and gets erased first.
+			bool Insert(IDType id, const ElementType& element)
+			{
+				if (!this->Contains(id))
+				{
+					this->PrepareSlot<IsChecked>(id);
+					this->InsertNew(id, element);
+					return true;
+				}
+				return false;
+			}
+
+			bool Insert(IDType id, ElementType&& element)
+			{
+				if (!this->Contains(id))
+				{
+					this->PrepareSlot<IsChecked>(id);
+					this->InsertNew(id, std::move(element));
+					return true;
+				}
+				return false;
+			}
+
+			// Constructs the element of an absent id from args at the dense tail and returns it.
+			// A present id throws std::invalid_argument with CheckedAccess and is only asserted otherwise.
+			template<typename... Args>
+				requires std::constructible_from<ElementType, Args&&...>
+			ElementType& Emplace(IDType id, Args&&... args)
+			{
+				if constexpr (IsChecked)
+				{
+					if (this->Contains(id))
+						throw std::invalid_argument("SparseSet::Emplace: ID is already present");
+				}
+				assert(!this->Contains(id));
+				this->PrepareSlot<IsChecked>(id);
+				return this->InsertNew(id, std::forward<Args>(args)...);
+			}
+
+			// Returns the element of id, constructing it from args first if id is absent. Costs one sparse lookup when present.
+			template<typename... Args>
+				requires std::constructible_from<ElementType, Args&&...>
+			ElementType& GetOrEmplace(IDType id, Args&&... args)
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex != InvalidIndex)
+					return Access<false>(m_Elements, elementIndex);
+
+				this->PrepareSlot<IsChecked>(id);
+				return this->InsertNew(id, std::forward<Args>(args)...);
+			}
+
+			// Assigns value to the element of id, or inserts it if id is absent. Returns true if it was inserted.
+			// An assignment marks the element dirty in a tracked set.
+			template<typename T>
+				requires std::constructible_from<ElementType, T&&> && std::assignable_from<ElementType&, T&&>
+			bool InsertOrAssign(IDType id, T&& value)
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex != InvalidIndex)
+				{
+					Access<false>(m_Elements, elementIndex) = std::forward<T>(value);
+					m_Changes.Mark(elementIndex);
+					return false;
+				}
+
+				this->PrepareSlot<IsChecked>(id);
+				this->InsertNew(id, std::forward<T>(value));
+				return true;
+			}
+
+			bool Erase(IDType id)
+			{
+				if (this->Contains(id))
+				{
+					this->EraseExisting<IsChecked>(id);
+					this->AutoCompact();
+					return true;
+				}
+				return false;
+			}
+
+			// The Unchecked variants skip the existence test and all bounds checks.
+			// The caller guarantees that the ID is below NumSupportedElements() and is absent (Insert) or present (Erase/Get).
+			// With VersionBits, InsertUnchecked still erases an element stored under another version of the same index, like Insert.
+			void InsertUnchecked(IDType id, const ElementType& element)
+			{
+				assert(!this->Contains(id));
+				if constexpr (IsVersioned)
+				{
+					this->EraseStale(id);
+				}
+				this->InsertNew(id, element);
+			}
+
+			void InsertUnchecked(IDType id, ElementType&& element)
+			{
+				assert(!this->Contains(id));
+				if constexpr (IsVersioned)
+				{
+					this->EraseStale(id);
+				}
+				this->InsertNew(id, std::move(element));
+			}
+
+			void EraseUnchecked(IDType id)
+			{
+				assert(this->Contains(id));
+				this->EraseExisting<false>(id);
+				this->AutoCompact();
+			}
+
+			// Inserts every ID that isn't present yet and returns how many were inserted, with the same outcome as calling Insert for each pair in order.
+			// The sparse index grows once for the largest ID. For trivially copyable elements of an unversioned set, a batch without present or repeated IDs is copied with a single memcpy.
+			// With VersionBits the pairs are inserted one by one, since a later version in the batch replaces an earlier one of the same index.
+			std::size_t InsertBatch(std::span<const IDType> ids, std::span<const ElementType> elements) requires std::copy_constructible<ElementType>
+			{
+				if (ids.size() != elements.size())
+					throw std::invalid_argument("SparseSet::InsertBatch: ids and elements differ in length");
+
+				if (ids.empty())
+					return 0;
+
+				IDType maxIndex = 0;
+				for (const IDType id : ids)
+				{
+					maxIndex = std::max(maxIndex, IDTraits::IndexOf(id));
+				}
+				this->GrowFor<IsChecked>(maxIndex);
+
+				// Repeated or present IDs can keep a batch that looks too large within MaxElements, the one by one path checks every insert on its own.
+				const IndexType firstInserted = this->DenseSize();
+				const std::size_t required = static_cast<std::size_t>(firstInserted) + ids.size();
+				const std::size_t previousCapacity = m_Elements.capacity();
+				m_Elements.reserve(std::min(required, MaxElements));
+				m_Element_To_ID.reserve(std::min(required, MaxElements));
+				if (m_Elements.capacity() != previousCapacity)
+				{
+					m_Stats.OnDenseResize(m_Elements.capacity());
+				}
+
+				if constexpr (!std::is_trivially_copyable_v<ElementType> || IsVersioned)
+				{
+					return this->InsertEach(ids, elements);
+				}
+				else
+				{
+					if (required > MaxElements)
+						return this->InsertEach(ids, elements);
+
+					m_Elements.resize(required);
+					m_Element_To_ID.resize(required);
+
+					std::size_t numInserted = 0;
+					std::size_t numContiguous = ids.size();
+					for (std::size_t i = 0; i < ids.size(); i++)
+					{
+						const IDType id = ids[i];
+						if (m_ID_To_Element.Find(IDTraits::IndexOf(id)) != EmptySlot)
+						{
+							numContiguous = std::min(numContiguous, i);
+							continue;
+						}
+
+						const IndexType elementIndex = static_cast<IndexType>(firstInserted + numInserted);
+						m_Element_To_ID[elementIndex] = id;
+						if (numContiguous != ids.size())
+						{
+							m_Elements[elementIndex] = elements[i];
+						}
+						this->StoreSlot<false>(id, elementIndex);
+						m_Changes.OnInserted(id, elementIndex);
+						numInserted++;
+					}
+
+					std::memcpy(m_Elements.data() + firstInserted, elements.data(), numContiguous * sizeof(ElementType));
+					m_Elements.resize(firstInserted + numInserted);
+					m_Element_To_ID.resize(firstInserted + numInserted);
+					m_Stats.OnInsert(numInserted);
+
+					if (m_Observer.Observer)
+					{
+						for (std::size_t i = firstInserted; i < m_Element_To_ID.size(); i++)
+						{
+							m_Observer.Observer->OnInserted(m_Element_To_ID[i]);
+						}
+					}
+					return numInserted;
+				}
+			}
+
+			// Builds a set from unsorted ids and their elements in a few parallel passes over the executor, see StdParallelExecutor.
+			// The sparse index is sized once for the largest ID, every ID claims its slot with an atomic scatter and the dense arrays are copied in chunks.
+			// IDs that share an index, including other versions of it, are resolved by duplicates. Dense order follows the input order of the kept IDs.
+			// With a paged index or occupancy bits the slots are stored on the calling thread after the parallel copy. Change tracking starts out clean.
+			// Build only wins with several hardware threads and inputs that span many ParallelMinChunkBytes chunks. Its extra passes and atomics make it
+			// about 1.1-3x slower than one InsertBatch on a single core, so prefer InsertBatch there when the IDs are known to be distinct.
+			template<typename Executor = StdParallelExecutor>
+			[[nodiscard]] static SparseSet Build(std::span<const IDType> ids, std::span<const ElementType> elements, DuplicateIDPolicy duplicates = DuplicateIDPolicy::Throw,
+				Executor&& executor = {}, const AllocatorType& allocator = AllocatorType()) requires IsTriviallyCopyable<ElementType>
+			{
+				if (ids.size() != elements.size())
+					throw std::invalid_argument("SparseSet::Build: ids and elements differ in length");
+
+				SparseSet set(allocator);
+				if (ids.empty())
+					return set;
+
+				const detail::ParallelChunking chunking(ids.data(), sizeof(IDType), ids.size(), Config::ParallelMinChunkBytes);
+				auto forEachChunk = [&](auto&& body)
+					{
+						if (chunking.NumChunks == 1)
+						{
+							body(std::size_t(0));
+						}
+						else
+						{
+							executor(chunking.NumChunks, body);
+						}
+					};
+
+				std::vector<IDType> chunkMax(chunking.NumChunks, 0);
+				forEachChunk([&](std::size_t chunk)
+					{
+						for (std::size_t i = chunking.Begin(chunk); i < chunking.End(chunk); i++)
+						{
+							chunkMax[chunk] = std::max(chunkMax[chunk], IDTraits::IndexOf(ids[i]));
+						}
+					});
+				const IDType maxIndex = *std::max_element(chunkMax.begin(), chunkMax.end());
+				if (maxIndex > MaxID)
+					throw std::out_of_range("SparseSet::Build: ID exceeds MaxID");
+
+				// Each index ends up holding the input position that wins it. A flat index is used as scratch space and overwritten with the final slots.
+				// Input positions at or past EmptySlot, possible when duplicates collapse more IDs than IndexType can count, need a full width scratch instead.
+				set.m_ID_To_Element.Resize(static_cast<std::size_t>(maxIndex) + 1);
+				std::size_t count;
+				if (ids.size() < EmptySlot)
+				{
+					if constexpr (IsPaged)
+					{
+						DenseVector<IndexType> scratch(static_cast<std::size_t>(maxIndex) + 1, EmptySlot, set.m_Element_To_ID.get_allocator());
+						count = BuildFromPositions(set, ids, elements, duplicates, chunking, forEachChunk, scratch.data());
+					}
+					else
+					{
+						count = BuildFromPositions(set, ids, elements, duplicates, chunking, forEachChunk, set.m_ID_To_Element.Data());
+					}
+				}
+				else
+				{
+					DenseVector<std::size_t> scratch(static_cast<std::size_t>(maxIndex) + 1, std::numeric_limits<std::size_t>::max(), set.m_Element_To_ID.get_allocator());
+					count = BuildFromPositions(set, ids, elements, duplicates, chunking, forEachChunk, scratch.data());
+				}
+
+				assert(set.m_Element_To_ID.size() == count);
+				set.m_Stats.OnSparseResize(set.m_ID_To_Element.Size());
+				set.m_Stats.OnDenseResize(set.m_Elements.capacity());
+				set.m_Stats.OnInsert(count);
+				return set;
+			}
+
+			// Erases every present ID and returns how many were erased.
+			// Removals run from the highest dense index down so that the swap-with-last never relocates an element that is erased later in the batch.
+			std::size_t EraseBatch(std::span<const IDType> ids)
+			{
+				if (m_Observer.Observer)
+				{
+					// The observer may reorder elements while an ID is being erased, which invalidates collected dense indices.
+					return static_cast<std::size_t>(std::count_if(ids.begin(), ids.end(), [this](IDType id) { return this->Erase(id); }));
+				}
+
+				DenseVector<IndexType> elementIndices(m_Element_To_ID.get_allocator());
+				elementIndices.reserve(ids.size());
+				for (const IDType id : ids)
+				{
+					const IndexType elementIndex = this->FindElementIndex(id);
+					if (elementIndex != InvalidIndex)
+					{
+						elementIndices.push_back(elementIndex);
+					}
+				}
+
+				std::sort(elementIndices.begin(), elementIndices.end(), std::greater<IndexType>());
+				elementIndices.erase(std::unique(elementIndices.begin(), elementIndices.end()), elementIndices.end());
+
+				for (const IndexType elementIndex : elementIndices)
+				{
+					this->EraseAt<false>(elementIndex);
+				}
+				this->AutoCompact();
+				return elementIndices.size();
+			}
+
+			// Copies the element of ids[i] into out[i]. Every ID has to be present, like for Get().
+			void GatherBatch(std::span<const IDType> ids, std::span<ElementType> out) const
+			{
+				if (out.size() < ids.size())
+					throw std::invalid_argument("SparseSet::GatherBatch: out is smaller than ids");
+
+				for (std::size_t i = 0; i < ids.size(); i++)
+				{
+					out[i] = Access<IsChecked>(m_Elements, this->LoadSlot<IsChecked>(ids[i]));
+				}
+			}
+
+			[[nodiscard]] ElementType& Get(IDType id)
+			{
+				const IndexType elementIndex = this->LoadSlot<IsChecked>(id);
+				return Access<IsChecked>(m_Elements, elementIndex);
+			}
+
+			[[nodiscard]] const ElementType& Get(IDType id) const
+			{
+				const IndexType elementIndex = this->LoadSlot<IsChecked>(id);
+				return Access<IsChecked>(m_Elements, elementIndex);
+			}
+
+			[[nodiscard]] ElementType& GetUnchecked(IDType id)
+			{
+				return Access<false>(m_Elements, this->LoadSlot<false>(id));
+			}
+
+			[[nodiscard]] const ElementType& GetUnchecked(IDType id) const
+			{
+				return Access<false>(m_Elements, this->LoadSlot<false>(id));
+			}
+
+			[[nodiscard]] std::optional<std::reference_wrapper<ElementType>> GetIfExists(IDType id)
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex != InvalidIndex)
+				{
+					return std::optional<std::reference_wrapper<ElementType>>{std::ref(Access<false>(m_Elements, elementIndex))};
+				}
+				else
+				{
+					m_Stats.OnFailedLookup();
+					return std::nullopt;
+				}
+			}
+
+			[[nodiscard]] std::optional<std::reference_wrapper<const ElementType>> GetIfExists(IDType id) const
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex != InvalidIndex)
+				{
+					return std::optional<std::reference_wrapper<const ElementType>>{std::ref(Access<false>(m_Elements, elementIndex))};
+				}
+				else
+				{
+					m_Stats.OnFailedLookup();
+					return std::nullopt;
+				}
+			}
+
+			[[nodiscard]] DenseVector<ElementType>& GetData() { return m_Elements; }
+
+			[[nodiscard]] const DenseVector<ElementType>& GetData() const { return m_Elements; }
+
+			[[nodiscard]] AllocatorType GetAllocator() const { return AllocatorType(m_Elements.get_allocator()); }
+
+			// Number of live elements. GetData() holds exactly Size() elements, Erase pops the vacated tail slot.
+			[[nodiscard]] std::size_t Size() const { return m_Element_To_ID.size(); }
+
+			[[nodiscard]] std::span<ElementType> GetElements() { return { m_Elements.data(), this->Size() }; }
+
+			[[nodiscard]] std::span<const ElementType> GetElements() const { return { m_Elements.data(), this->Size() }; }
+
+			// IDs of the live elements, GetIDs()[i] is the ID of GetElements()[i].
+			[[nodiscard]] std::span<const IDType> GetIDs() const { return { m_Element_To_ID.data(), this->Size() }; }
+
+			[[nodiscard]] ElementType* begin() { return m_Elements.data(); }
+			[[nodiscard]] ElementType* end() { return m_Elements.data() + this->Size(); }
+			[[nodiscard]] const ElementType* begin() const { return m_Elements.data(); }
+			[[nodiscard]] const ElementType* end() const { return m_Elements.data() + this->Size(); }
+
+			// Iterates the live elements as (id, element&) pairs.
+			[[nodiscard]] EachRange<false> Each()
+			{
+				return { { m_Element_To_ID.data(), m_Elements.data() }, { m_Element_To_ID.data() + this->Size(), m_Elements.data() + this->Size() } };
+			}
+
+			[[nodiscard]] EachRange<true> Each() const
+			{
+				return { { m_Element_To_ID.data(), m_Elements.data() }, { m_Element_To_ID.data() + this->Size(), m_Elements.data() + this->Size() } };
+			}
+
+			// With Config::OccupancyBits an unversioned set answers from the bitset, which stays cache resident far longer than the sparse slots.
+			[[nodiscard]] bool Exists(IDType id) const
+			{
+				const bool exists = this->Contains(id);
+				if (!exists)
+				{
+					m_Stats.OnFailedLookup();
+				}
+				return exists;
+			}
+
+			// Releases the unused dense capacity and the change tracking and occupancy words past the live range.
+			// With Config::GrowOnInsert the sparse index above the highest present ID is released too, see CompactSparse, so NumSupportedElements() can drop for InsertUnchecked.
+			void ShrinkToFit()
+			{
+				this->Compact(this->Size());
+			}
+
+			void Reserve(IDType numEntries)
+			{
+				const std::size_t previousSize = m_ID_To_Element.Size();
+				m_ID_To_Element.Resize(numEntries);
+				if (m_ID_To_Element.Size() != previousSize)
+				{
+					m_Stats.OnSparseResize(m_ID_To_Element.Size());
+				}
+			}
+
+			// Snapshot of the counters of a Config::Stats policy that provides Snapshot(), such as CountingStats.
+			[[nodiscard]] auto GetStats() const requires requires(const typename Config::Stats& stats) { stats.Snapshot(); }
+			{
+				return m_Stats.Snapshot();
+			}
+
+			// The Config::Stats instance of this set, for policies that need setup such as a telemetry sink.
+			[[nodiscard]] typename Config::Stats& GetStatsPolicy() { return m_Stats; }
+
+			[[nodiscard]] const typename Config::Stats& GetStatsPolicy() const { return m_Stats; }
+
+			[[nodiscard]] std::size_t NumSupportedElements() const
+			{
+				return m_ID_To_Element.Size();
+			}
+
+			[[nodiscard]] std::size_t InternalSize() const
+			{
+				return m_Elements.capacity();
+			}
+
+			[[nodiscard]] SparseSetMemoryUsage MemoryUsage() const
+			{
+				SparseSetMemoryUsage usage;
+				usage.SparseLiveBytes = this->Size() * sizeof(IndexType);
+				usage.SparseReservedBytes = m_ID_To_Element.ReservedBytes();
+				usage.ReverseIDLiveBytes = this->Size() * sizeof(IDType);
+				usage.ReverseIDReservedBytes = m_Element_To_ID.capacity() * sizeof(IDType);
+				usage.DenseLiveBytes = this->Size() * sizeof(ElementType);
+				usage.DenseReservedBytes = m_Elements.capacity() * sizeof(ElementType);
+				usage.AuxiliaryReservedBytes = m_Changes.ReservedBytes() + m_Occupancy.ReservedBytes();
+				return usage;
+			}
+
+			// Releases the sparse index above the highest present ID index. Inserting a larger ID grows it again.
+			// The highest index comes from the occupancy bits if enabled, otherwise from a scan of the dense IDs.
+			// Without Config::GrowOnInsert the released range has to be reserved again before its IDs can be inserted.
+			void CompactSparse()
+			{
+				std::size_t numIDs = 0;
+				if constexpr (HasOccupancy)
+				{
+					numIDs = m_Occupancy.Extent();
+					m_Occupancy.ShrinkToFit();
+				}
+				else
+				{
+					for (IndexType i = 0; i < this->DenseSize(); i++)
+					{
+						numIDs = std::max(numIDs, static_cast<std::size_t>(IDTraits::IndexOf(m_Element_To_ID[i])) + 1);
+					}
+				}
+
+				const std::size_t previousSize = m_ID_To_Element.Size();
+				m_ID_To_Element.Truncate(numIDs);
+				if (m_ID_To_Element.Size() != previousSize)
+				{
+					m_Stats.OnSparseResize(m_ID_To_Element.Size());
+				}
+			}
+
+			// True if Size() is below minLoadFactor times the dense capacity and that capacity holds at least Config::AutoCompactMinBytes.
+			[[nodiscard]] bool NeedsCompaction(double minLoadFactor = Config::AutoCompactLoadFactor) const
+			{
+				const std::size_t capacity = m_Elements.capacity();
+				return capacity * sizeof(ElementType) >= Config::AutoCompactMinBytes && static_cast<double>(this->Size()) < static_cast<double>(capacity) * minLoadFactor;
+			}
+
+			// Compacts like ShrinkToFit if NeedsCompaction(minLoadFactor), but leaves the dense capacity at Size() / ((1 + minLoadFactor) / 2).
+			// The load then sits halfway between minLoadFactor and 1, so it takes inserts or erases in proportion to Size() before the next compaction.
+			// Erase calls this after every removal when Config::AutoCompactLoadFactor is set, otherwise call it at a convenient point such as between frames.
+			// Throws std::invalid_argument unless minLoadFactor is below 1, which would compact again right after the next growth.
+			bool CompactIfNeeded(double minLoadFactor = Config::AutoCompactLoadFactor)
+			{
+				if (!(minLoadFactor < 1.0))
+					throw std::invalid_argument("SparseSet::CompactIfNeeded: minLoadFactor has to be below 1");
+
+				if (!this->NeedsCompaction(minLoadFactor))
+					return false;
+
+				this->Compact(static_cast<std::size_t>(static_cast<double>(this->Size()) * 2.0 / (1.0 + minLoadFactor)) + 1);
+				return true;
+			}
+
+			[[nodiscard]] IndexType GetElementIndex(IDType id) const { return this->LoadSlot<IsChecked>(id); }
+
+			// Swaps the dense positions of two live elements and patches the sparse index for both.
+			void SwapAt(IndexType lhsIndex, IndexType rhsIndex)
+			{
+				if constexpr (IsChecked)
+				{
+					if (lhsIndex >= this->DenseSize() || rhsIndex >= this->DenseSize())
+						throw std::out_of_range("SparseSet::SwapAt");
+				}
+
+				if (lhsIndex == rhsIndex)
+					return;
+
+				detail::SwapElements(Access<false>(m_Elements, lhsIndex), Access<false>(m_Elements, rhsIndex));
+				std::swap(Access<false>(m_Element_To_ID, lhsIndex), Access<false>(m_Element_To_ID, rhsIndex));
+				this->StoreSlot<false>(m_Element_To_ID[lhsIndex], lhsIndex);
+				this->StoreSlot<false>(m_Element_To_ID[rhsIndex], rhsIndex);
+				m_Changes.OnSwapped(lhsIndex, rhsIndex);
+			}
+
+			// Reorders the dense arrays so that comp(lhs, rhs) holds for elements in order and patches the sparse index once at the end.
+			// Throws std::logic_error if the set is observed, since an OwningGroup relies on the current order.
+			template<typename Compare>
+			void Sort(Compare comp)
+			{
+				this->SortIndices("SparseSet::Sort", [&](IndexType lhs, IndexType rhs) { return comp(std::as_const(m_Elements[lhs]), std::as_const(m_Elements[rhs])); });
+			}
+
+			template<typename Compare = std::less<IDType>>
+			void SortByID(Compare comp = Compare())
+			{
+				this->SortIndices("SparseSet::SortByID", [&](IndexType lhs, IndexType rhs) { return comp(m_Element_To_ID[lhs], m_Element_To_ID[rhs]); });
+			}
+
+			// Moves the IDs that other holds to the front, in other's dense order, followed by the rest in their current order.
+			// other can be any set with GetIDs(), so a group of sets can be walked in lockstep afterwards.
+			template<typename OtherSet>
+			void SortAs(const OtherSet& other)
+			{
+				this->ThrowIfObserved("SparseSet::SortAs");
+
+				std::vector<IndexType> order;
+				order.reserve(this->Size());
+				std::vector<bool> placed(this->Size(), false);
+				for (const IDType id : other.GetIDs())
+				{
+					const IndexType elementIndex = this->FindElementIndex(id);
+					if (elementIndex != InvalidIndex && !placed[elementIndex])
+					{
+						placed[elementIndex] = true;
+						order.push_back(elementIndex);
+					}
+				}
+				for (IndexType i = 0; i < this->DenseSize(); i++)
+				{
+					if (!placed[i])
+					{
+						order.push_back(i);
+					}
+				}
+				this->ApplyOrder(order);
+			}
+
+			// Bounded insertion sort for spreading a sort over frames. Performs at most maxSwaps adjacent swaps and returns true once the set is sorted.
+			// Every call costs one compare per element plus the swaps, which is cheap when only a few elements moved since the last call.
+			template<typename Compare>
+			bool SortIncremental(Compare comp, std::size_t maxSwaps)
+			{
+				this->ThrowIfObserved("SparseSet::SortIncremental");
+
+				std::size_t numSwaps = 0;
+				for (IndexType i = 1; i < this->DenseSize(); i++)
+				{
+					for (IndexType j = i; j > 0 && comp(std::as_const(m_Elements[j]), std::as_const(m_Elements[j - 1])); j--)
+					{
+						if (numSwaps == maxSwaps)
+							return false;
+
+						this->SwapAt(j, j - 1);
+						numSwaps++;
+					}
+				}
+				return true;
+			}
+
+			// At most one observer per set. Passing nullptr detaches the current one.
+			void SetObserver(SparseSetObserver<IDType>* observer)
+			{
+				if (observer && m_Observer.Observer && m_Observer.Observer != observer)
+					throw std::logic_error("SparseSet::SetObserver: the set is already observed");
+
+				m_Observer.Observer = observer;
+			}
+
+			[[nodiscard]] SparseSetObserver<IDType>* GetObserver() const { return m_Observer.Observer; }
+
+			// Writes a SparseSetFileHeader followed by the live IDs and elements as raw blocks.
+			// withSparseIndex appends the sparse slots up to the largest live index, which lets SparseSetView skip rebuilding them. Deserialize reads past that block.
+			// writer(const void* data, std::size_t size) is called with consecutive pieces of the output.
+			template<typename Writer>
+			void Serialize(Writer&& writer, bool withSparseIndex = false) const requires IsTriviallyCopyable<ElementType>
+			{
+				std::size_t numSparseSlots = 0;
+				if (withSparseIndex)
+				{
+					for (IndexType i = 0; i < this->DenseSize(); i++)
+					{
+						numSparseSlots = std::max<std::size_t>(numSparseSlots, static_cast<std::size_t>(IDTraits::IndexOf(m_Element_To_ID[i])) + 1);
+					}
+				}
+
+				SparseSetFileHeader header;
+				header.Describe<IDType, ElementType, IndexType>(Config::VersionBits, this->Size(), numSparseSlots);
+
+				constexpr std::byte padding[SparseSetFileHeader::BlockAlignment] = {};
+				auto pad = [&](std::uint64_t from, std::uint64_t to) { writer(static_cast<const void*>(padding), static_cast<std::size_t>(to - from)); };
+
+				writer(static_cast<const void*>(&header), sizeof(header));
+				pad(sizeof(header), header.IDsOffset);
+				writer(static_cast<const void*>(m_Element_To_ID.data()), this->Size() * sizeof(IDType));
+				pad(header.IDsOffset + header.Count * sizeof(IDType), header.ElementsOffset);
+				writer(static_cast<const void*>(m_Elements.data()), this->Size() * sizeof(ElementType));
+				if (numSparseSlots == 0)
+					return;
+
+				pad(header.ElementsOffset + header.Count * sizeof(ElementType), header.SparseOffset);
+				if constexpr (!IsPaged)
+				{
+					writer(static_cast<const void*>(m_ID_To_Element.Data()), numSparseSlots * sizeof(IndexType));
+				}
+				else
+				{
+					IndexType slots[256];
+					for (std::size_t first = 0; first < numSparseSlots; first += std::size(slots))
+					{
+						const std::size_t count = std::min(std::size(slots), numSparseSlots - first);
+						for (std::size_t i = 0; i < count; i++)
+						{
+							slots[i] = m_ID_To_Element.Find(first + i);
+						}
+						writer(static_cast<const void*>(slots), count * sizeof(IndexType));
+					}
+				}
+			}
+
+			// Replaces the contents with data written by Serialize and rebuilds the sparse index in one pass over the IDs.
+			// reader(void* data, std::size_t size) fills data with the next size bytes and returns false if it can't.
+			// Returns false and leaves the set unchanged if the data is truncated, was written with another ID or element layout or holds an ID twice.
+			// Change tracking starts out clean. Throws std::logic_error if the set is observed.
+			template<typename Reader>
+			[[nodiscard]] bool Deserialize(Reader&& reader) requires IsTriviallyCopyable<ElementType>
+			{
+				if (m_Observer.Observer)
+					throw std::logic_error("SparseSet::Deserialize: the set is observed");
+
+				SparseSetFileHeader header;
+				if (!reader(static_cast<void*>(&header), sizeof(header)) || !this->IsCompatible(header))
+					return false;
+
+				// The blocks grow as the reader delivers them, a header with a bogus Count fails on the missing bytes
+				SparseSet loaded(this->GetAllocator());
+				std::byte padding[SparseSetFileHeader::BlockAlignment];
+				if (!reader(static_cast<void*>(padding), static_cast<std::size_t>(header.IDsOffset - sizeof(header))) ||
+					!detail::ReadBlock(reader, loaded.m_Element_To_ID, header.Count) ||
+					!reader(static_cast<void*>(padding), static_cast<std::size_t>(header.ElementsOffset - header.IDsOffset - header.Count * sizeof(IDType))) ||
+					!detail::ReadBlock(reader, loaded.m_Elements, header.Count))
+					return false;
+
+				// The sparse block is rebuilt from the IDs, but has to be consumed so that a following record starts where the reader expects it
+				for (std::uint64_t remaining = header.End<IDType, ElementType, IndexType>() - (header.ElementsOffset + header.Count * sizeof(ElementType)); remaining != 0;)
+				{
+					const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, sizeof(padding)));
+					if (!reader(static_cast<void*>(padding), size))
+						return false;
+					remaining -= size;
+				}
+
+				if (!loaded.RebuildSparseIndex(static_cast<IndexType>(header.Count)))
+					return false;
+
+				*this = std::move(loaded);
+				return true;
+			}
+
+			// Change tracking, only available with Config::TrackChanges.
+			// Inserted elements start dirty, other elements only become dirty through MarkDirty. Dirty bits follow their element through Erase and SwapAt.
+			bool MarkDirty(IDType id) requires IsTracked
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex == InvalidIndex)
+					return false;
+
+				m_Changes.Mark(elementIndex);
+				return true;
+			}
+
+			[[nodiscard]] bool IsDirty(IDType id) const requires IsTracked
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				return elementIndex != InvalidIndex && m_Changes.IsDirty(elementIndex);
+			}
+
+			// Calls func(id, element&) for every dirty element, visiting 64 dense indices per bitset word.
+			template<typename Func>
+			void ForEachDirty(Func&& func) requires IsTracked
+			{
+				this->VisitDirty([&](std::size_t elementIndex) { func(m_Element_To_ID[elementIndex], m_Elements[elementIndex]); });
+			}
+
+			template<typename Func>
+			void ForEachDirty(Func&& func) const requires IsTracked
+			{
+				this->VisitDirty([&](std::size_t elementIndex) { func(m_Element_To_ID[elementIndex], m_Elements[elementIndex]); });
+			}
+
+			// IDs inserted and erased since the last ClearDirty, in call order. An ID can show up in both.
+			[[nodiscard]] std::span<const IDType> GetAddedIDs() const requires IsTracked { return m_Changes.Added(); }
+
+			[[nodiscard]] std::span<const IDType> GetRemovedIDs() const requires IsTracked { return m_Changes.Removed(); }
+
+			// Clears the dirty bits and the added and removed lists, typically once per replication tick.
+			void ClearDirty() requires IsTracked { m_Changes.Clear(); }
+
+			// Increases on every insert, erase and MarkDirty, so an unchanged value means nothing needs to be replicated.
+			[[nodiscard]] std::uint64_t GetChangeVersion() const requires IsTracked { return m_Changes.Version(); }
+
+			// The change version at the last ClearDirty, the only baseline WriteDelta can encode against.
+			[[nodiscard]] std::uint64_t GetDeltaBaselineVersion() const requires IsTracked { return m_Changes.ClearedVersion(); }
+
+			// Writes the changes since the last ClearDirty as a SparseSetDeltaHeader and raw blocks, see ApplyDelta.
+			// Returns false without writing if baselineVersion isn't GetDeltaBaselineVersion(), the receiver then needs a full Serialize.
+			// With baseline, the receiver's copy at baselineVersion, dirty elements that baseline holds are written XORed against it, which leaves mostly zero bytes for a compressor.
+			template<typename Writer>
+			bool WriteDelta(std::uint64_t baselineVersion, Writer&& writer, const SparseSet* baseline = nullptr) const requires IsTracked && IsTriviallyCopyable<ElementType>
+			{
+				if (baselineVersion != m_Changes.ClearedVersion())
+					return false;
+
+				std::vector<IDType> erased;
+				for (const IDType id : m_Changes.Removed())
+				{
+					if (!this->Contains(id))
+					{
+						erased.push_back(id);
+					}
+				}
+				std::sort(erased.begin(), erased.end());
+				erased.erase(std::unique(erased.begin(), erased.end()), erased.end());
+
+				std::vector<IDType> assignedIDs, xoredIDs;
+				std::vector<ElementType> assigned, xored;
+				this->VisitDirty([&](std::size_t elementIndex)
+					{
+						const IDType id = m_Element_To_ID[elementIndex];
+						const auto previous = baseline ? baseline->GetIfExists(id) : std::nullopt;
+						if (!previous)
+						{
+							assignedIDs.push_back(id);
+							assigned.push_back(m_Elements[elementIndex]);
+							return;
+						}
+
+						xoredIDs.push_back(id);
+						xored.push_back(detail::XorBytes(m_Elements[elementIndex], previous->get()));
+					});
+
+				SparseSetDeltaHeader header;
+				header.IDSize = sizeof(IDType);
+				header.VersionBits = static_cast<std::uint8_t>(Config::VersionBits);
+				header.ElementSize = static_cast<std::uint32_t>(sizeof(ElementType));
+				header.BaselineVersion = baselineVersion;
+				header.Version = m_Changes.Version();
+				header.NumErased = erased.size();
+				header.NumAssigned = assigned.size();
+				header.NumXored = xored.size();
+
+				writer(static_cast<const void*>(&header), sizeof(header));
+				writer(static_cast<const void*>(erased.data()), erased.size() * sizeof(IDType));
+				writer(static_cast<const void*>(assignedIDs.data()), assignedIDs.size() * sizeof(IDType));
+				writer(static_cast<const void*>(assigned.data()), assigned.size() * sizeof(ElementType));
+				writer(static_cast<const void*>(xoredIDs.data()), xoredIDs.size() * sizeof(IDType));
+				writer(static_cast<const void*>(xored.data()), xored.size() * sizeof(ElementType));
+				return true;
+			}
+
+			// Applies a delta written by WriteDelta: one EraseBatch, in place assignment of present IDs and one InsertBatch for the rest.
+			// The whole delta is read and validated before anything changes. Returns false and leaves the set unchanged for truncated or incompatible data,
+			// if an XORed element has no counterpart here, if an inserted ID is out of range or if the result would hold more than MaxElements. version, if given, receives the sender's change version the set now mirrors.
+			template<typename Reader>
+			[[nodiscard]] bool ApplyDelta(Reader&& reader, std::uint64_t* version = nullptr) requires IsTriviallyCopyable<ElementType>
+			{
+				SparseSetDeltaHeader header;
+				if (!reader(static_cast<void*>(&header), sizeof(header)) ||
+					header.Magic != SparseSetDeltaHeader::MagicValue ||
+					header.Format != SparseSetDeltaHeader::CurrentFormat ||
+					header.IDSize != sizeof(IDType) ||
+					header.VersionBits != Config::VersionBits ||
+					header.LittleEndian != (std::endian::native == std::endian::little) ||
+					header.ElementSize != sizeof(ElementType))
+					return false;
+
+				// The sender holds every assigned and XORed ID at once. Erased IDs are distinct, but with VersionBits several versions of one index can go in one tick
+				if (header.NumAssigned > MaxElements || header.NumXored > MaxElements - header.NumAssigned ||
+					(header.NumErased != 0 && header.NumErased - 1 > std::numeric_limits<IDType>::max()))
+					return false;
+
+				std::vector<IDType> erased, assignedIDs, xoredIDs;
+				std::vector<ElementType> assigned, xored;
+				if (!detail::ReadBlock(reader, erased, header.NumErased) ||
+					!detail::ReadBlock(reader, assignedIDs, header.NumAssigned) || !detail::ReadBlock(reader, assigned, header.NumAssigned) ||
+					!detail::ReadBlock(reader, xoredIDs, header.NumXored) || !detail::ReadBlock(reader, xored, header.NumXored))
+					return false;
+
+				std::vector<IDType> sortedErased = erased;
+				std::sort(sortedErased.begin(), sortedErased.end());
+				sortedErased.erase(std::unique(sortedErased.begin(), sortedErased.end()), sortedErased.end());
+				auto survivesErase = [&](IDType id) { return this->Contains(id) && !std::binary_search(sortedErased.begin(), sortedErased.end(), id); };
+				if (!std::all_of(xoredIDs.begin(), xoredIDs.end(), survivesErase))
+					return false;
+
+				// Checked up front so that a delta that doesn't fit fails before the set changes
+				const std::size_t numErased = static_cast<std::size_t>(std::count_if(sortedErased.begin(), sortedErased.end(), [this](IDType id) { return this->Contains(id); }));
+				const std::size_t numNew = static_cast<std::size_t>(std::count_if(assignedIDs.begin(), assignedIDs.end(), [&](IDType id) { return !survivesErase(id); }));
+				if (numNew > MaxElements - (this->Size() - numErased))
+					return false;
+
+				// New IDs have to be addressable, beyond the sparse index only if it grows on insert
+				auto isAddressable = [this](IDType id)
+					{
+						const std::size_t index = IDTraits::IndexOf(id);
+						return Config::GrowOnInsert ? index <= MaxID : index < m_ID_To_Element.Size();
+					};
+				for (const IDType id : assignedIDs)
+				{
+					if (!survivesErase(id) && !isAddressable(id))
+						return false;
+				}
+
+				this->EraseBatch(erased);
+
+				std::vector<IDType> insertedIDs;
+				std::vector<ElementType> inserted;
+				for (std::size_t i = 0; i < assignedIDs.size(); i++)
+				{
+					const IndexType elementIndex = this->FindElementIndex(assignedIDs[i]);
+					if (elementIndex != InvalidIndex)
+					{
+						m_Elements[elementIndex] = assigned[i];
+						m_Changes.Mark(elementIndex);
+					}
+					else
+					{
+						insertedIDs.push_back(assignedIDs[i]);
+						inserted.push_back(assigned[i]);
+					}
+				}
+				for (std::size_t i = 0; i < xoredIDs.size(); i++)
+				{
+					const IndexType elementIndex = this->FindElementIndex(xoredIDs[i]);
+					m_Elements[elementIndex] = detail::XorBytes(m_Elements[elementIndex], xored[i]);
+					m_Changes.Mark(elementIndex);
+				}
+				this->InsertBatch(insertedIDs, inserted);
+
+				if (version)
+				{
+					*version = header.Version;
+				}
+				return true;
+			}
+
+			// Calls func(element&) for every live element, split over the executor in cache line aligned chunks.
+			// func runs concurrently on different chunks and in order within one, the default executor runs the chunks on std::thread workers or std::execution::par so func may lock. It must not insert, erase or reorder.
+			template<typename Func, typename Executor = StdParallelExecutor>
+			void ParallelForEach(Func&& func, Executor&& executor = {})
+			{
+				this->ParallelChunks([&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							func(m_Elements[i]);
+						}
+					}, executor);
+			}
+
+			template<typename Func, typename Executor = StdParallelExecutor>
+			void ParallelForEach(Func&& func, Executor&& executor = {}) const
+			{
+				this->ParallelChunks([&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							func(m_Elements[i]);
+						}
+					}, executor);
+			}
+
+			// Same as ParallelForEach but calls func(id, element&).
+			template<typename Func, typename Executor = StdParallelExecutor>
+			void ParallelForEachWithID(Func&& func, Executor&& executor = {})
+			{
+				this->ParallelChunks([&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							func(m_Element_To_ID[i], m_Elements[i]);
+						}
+					}, executor);
+			}
+
+			template<typename Func, typename Executor = StdParallelExecutor>
+			void ParallelForEachWithID(Func&& func, Executor&& executor = {}) const
+			{
+				this->ParallelChunks([&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							func(m_Element_To_ID[i], m_Elements[i]);
+						}
+					}, executor);
+			}
+
+			// Calls func(id, element&) for every present ID of ids, in order, and returns how many were present. Absent IDs are skipped.
+			// While ids[i] is processed the sparse slot of ids[i + distance] and the element of ids[i + distance / 2] are prefetched,
+			// so the two dependent misses of each lookup overlap with the work on earlier IDs.
+			template<typename Func>
+			std::size_t ForEachGet(std::span<const IDType> ids, Func&& func, std::size_t distance = Config::PrefetchDistance)
+			{
+				return this->PrefetchedLookup(ids, distance, [&](IDType id, IndexType elementIndex) { func(id, m_Elements[elementIndex]); });
+			}
+
+			template<typename Func>
+			std::size_t ForEachGet(std::span<const IDType> ids, Func&& func, std::size_t distance = Config::PrefetchDistance) const
+			{
+				return this->PrefetchedLookup(ids, distance, [&](IDType id, IndexType elementIndex) { func(id, m_Elements[elementIndex]); });
+			}
+
+			// Calls func(id, element&) for every element in ascending ID index order, only available with Config::OccupancyBits.
+			template<typename Func>
+			void ForEachInIdOrder(Func&& func) requires HasOccupancy
+			{
+				m_Occupancy.ForEach([&](std::size_t index)
+					{
+						const IndexType elementIndex = m_ID_To_Element.Slot(index) & SlotIndexMask;
+						func(m_Element_To_ID[elementIndex], m_Elements[elementIndex]);
+					});
+			}
+
+			template<typename Func>
+			void ForEachInIdOrder(Func&& func) const requires HasOccupancy
+			{
+				m_Occupancy.ForEach([&](std::size_t index)
+					{
+						const IndexType elementIndex = m_ID_To_Element.Slot(index) & SlotIndexMask;
+						func(m_Element_To_ID[elementIndex], m_Elements[elementIndex]);
+					});
+			}
+
+			// Occupancy bits of the ID indices, bit i % 64 of word i / 64, and one summary bit per non zero word. See IntersectOccupancy.
+			// A paged set keeps the words in pages, so only GetOccupancyWord reaches them. Words past NumOccupancyWords() are zero.
+			[[nodiscard]] std::span<const std::uint64_t> GetOccupancyWords() const requires HasOccupancy && (!IsPaged) { return m_Occupancy.Words(); }
+
+			[[nodiscard]] std::uint64_t GetOccupancyWord(std::size_t wordIndex) const requires HasOccupancy { return m_Occupancy.Word(wordIndex); }
+
+			[[nodiscard]] std::size_t NumOccupancyWords() const requires HasOccupancy { return m_Occupancy.NumWords(); }
+
+			[[nodiscard]] std::span<const std::uint64_t> GetOccupancySummary() const requires HasOccupancy { return m_Occupancy.Summary(); }
+
+			// Sets bit i % 64 of mask[i / 64] if ids[i] is present and clears it otherwise. mask needs (ids.size() + 63) / 64 words.
+			void ExistsMask(std::span<const IDType> ids, std::span<std::uint64_t> mask) const
+			{
+				if (mask.size() < (ids.size() + 63) / 64)
+					throw std::invalid_argument("SparseSet::ExistsMask: mask is too small");
+
+				for (std::size_t first = 0; first < ids.size(); first += 64)
+				{
+					mask[first / 64] = this->ExistsWord(ids.subspan(first, std::min<std::size_t>(64, ids.size() - first)));
+				}
+			}
+
+			// Copies the present IDs of ids to out, keeping their order, and returns how many were copied. out needs ids.size() entries.
+			std::size_t FilterExisting(std::span<const IDType> ids, std::span<IDType> out) const
+			{
+				if (out.size() < ids.size())
+					throw std::invalid_argument("SparseSet::FilterExisting: out is smaller than ids");
+
+				std::size_t numFound = 0;
+				for (std::size_t first = 0; first < ids.size(); first += 64)
+				{
+					std::uint64_t word = this->ExistsWord(ids.subspan(first, std::min<std::size_t>(64, ids.size() - first)));
+					while (word != 0)
+					{
+						out[numFound++] = ids[first + static_cast<std::size_t>(std::countr_zero(word))];
+						word &= word - 1;
+					}
+				}
+				return numFound;
+			}
 
 			private:
-				std::vector<IDType> m_ID_To_Element;
-				std::vector<IDType> m_Element_To_ID;
-				std::vector<ElementType> m_Elements;
-				IDType m_CurrentLast;
+				// The views probe through Contains and FindElementIndex, so that only user lookups reach Config::Stats.
+				template<typename... Sets>
+				friend class JoinView;
+
+				template<typename... Sets>
+				friend class OwningGroup;
+
+				template<bool Checked, typename Vector>
+				[[nodiscard]] static decltype(auto) Access(Vector& vector, std::size_t index)
+				{
+					if constexpr (Checked)
+					{
+						return vector.at(index);
+					}
+					else
+					{
+						assert(index < vector.size());
+						return vector[index];
+					}
+				}
+
+				[[nodiscard]] static IndexType EncodeSlot(IDType id, IndexType elementIndex)
+				{
+					if constexpr (IsVersioned)
+					{
+						return elementIndex == InvalidIndex ? EmptySlot : static_cast<IndexType>((static_cast<IndexType>(IDTraits::VersionOf(id)) << SlotIndexBits) | elementIndex);
+					}
+					else
+					{
+						return elementIndex;
+					}
+				}
+
+				// Returns the dense index stored for id, or InvalidIndex if the slot is empty or holds another version.
+				[[nodiscard]] static IndexType DecodeSlot(IDType id, IndexType slot)
+				{
+					if constexpr (IsVersioned)
+					{
+						if (slot == EmptySlot || (slot >> SlotIndexBits) != static_cast<IndexType>(IDTraits::VersionOf(id)))
+							return InvalidIndex;
+
+						return slot & SlotIndexMask;
+					}
+					else
+					{
+						return slot;
+					}
+				}
+
+				// The gather kernels read raw slots, so they only apply to an unversioned flat index whose slots are IDType wide.
+				[[nodiscard]] std::uint64_t ExistsWord(std::span<const IDType> ids) const
+				{
+					if constexpr (!IsPaged && !IsVersioned && std::is_same_v<IndexType, IDType>)
+					{
+						return detail::ExistsWord<IDType>(m_ID_To_Element.Data(), m_ID_To_Element.Size(), ids.data(), ids.size());
+					}
+					else
+					{
+						std::uint64_t word = 0;
+						for (std::size_t i = 0; i < ids.size(); i++)
+						{
+							word |= static_cast<std::uint64_t>(this->FindElementIndex(ids[i]) != InvalidIndex) << i;
+						}
+						return word;
+					}
+				}
+
+				// Scatter, winner and copy passes of Build over positions, which starts out filled with NoPosition. Returns the number of kept IDs.
+				template<UnsignedInteger PositionType, typename ForEachChunk>
+				static std::size_t BuildFromPositions(SparseSet& set, std::span<const IDType> ids, std::span<const ElementType> elements, DuplicateIDPolicy duplicates,
+					const detail::ParallelChunking& chunking, ForEachChunk& forEachChunk, PositionType* positions)
+				{
+					constexpr PositionType NoPosition = std::numeric_limits<PositionType>::max();
+
+					std::atomic<bool> hasDuplicates = false;
+					forEachChunk([&](std::size_t chunk)
+						{
+							for (std::size_t i = chunking.Begin(chunk); i < chunking.End(chunk); i++)
+							{
+								std::atomic_ref<PositionType> position(positions[IDTraits::IndexOf(ids[i])]);
+								const PositionType claim = static_cast<PositionType>(i);
+								PositionType current = NoPosition;
+								if (position.compare_exchange_strong(current, claim, std::memory_order_relaxed))
+									continue;
+
+								hasDuplicates.store(true, std::memory_order_relaxed);
+								if (duplicates == DuplicateIDPolicy::Throw)
+									continue;
+
+								const bool wins = duplicates == DuplicateIDPolicy::FirstWins ? claim < current : claim > current;
+								while (wins && !position.compare_exchange_weak(current, claim, std::memory_order_relaxed))
+								{
+									if (duplicates == DuplicateIDPolicy::FirstWins ? claim > current : claim < current)
+										break;
+								}
+							}
+						});
+
+					if (hasDuplicates && duplicates == DuplicateIDPolicy::Throw)
+						throw std::invalid_argument("SparseSet::Build: ids holds an ID twice");
+
+					// Without duplicates every input position is kept, otherwise each chunk flags and counts its winners and writes them from its offset in the dense arrays.
+					// The flags are taken before any slot is overwritten with its final value.
+					std::vector<std::size_t> chunkOffsets(chunking.NumChunks + 1, 0);
+					std::vector<std::uint8_t> kept(hasDuplicates ? ids.size() : 0);
+					if (hasDuplicates)
+					{
+						forEachChunk([&](std::size_t chunk)
+							{
+								std::size_t numKept = 0;
+								for (std::size_t i = chunking.Begin(chunk); i < chunking.End(chunk); i++)
+								{
+									kept[i] = positions[IDTraits::IndexOf(ids[i])] == static_cast<PositionType>(i);
+									numKept += kept[i];
+								}
+								chunkOffsets[chunk + 1] = numKept;
+							});
+						std::partial_sum(chunkOffsets.begin(), chunkOffsets.end(), chunkOffsets.begin());
+					}
+					else
+					{
+						for (std::size_t chunk = 0; chunk <= chunking.NumChunks; chunk++)
+						{
+							chunkOffsets[chunk] = chunking.Begin(chunk);
+						}
+					}
+
+					const std::size_t count = chunkOffsets.back();
+					CheckCapacity(count, "SparseSet::Build: ids holds more than MaxElements distinct IDs");
+					set.m_Elements.resize(count);
+					set.m_Element_To_ID.resize(count);
+
+					constexpr bool ParallelSlots = !IsPaged && !HasOccupancy && std::same_as<PositionType, IndexType>;
+					forEachChunk([&](std::size_t chunk)
+						{
+							std::size_t elementIndex = chunkOffsets[chunk];
+							if (!hasDuplicates)
+							{
+								const std::size_t first = chunking.Begin(chunk);
+								const std::size_t num = chunking.End(chunk) - first;
+								std::memcpy(set.m_Elements.data() + first, elements.data() + first, num * sizeof(ElementType));
+								std::memcpy(set.m_Element_To_ID.data() + first, ids.data() + first, num * sizeof(IDType));
+							}
+
+							for (std::size_t i = chunking.Begin(chunk); i < chunking.End(chunk); i++)
+							{
+								if (hasDuplicates)
+								{
+									if (!kept[i])
+										continue;
+
+									set.m_Elements[elementIndex] = elements[i];
+									set.m_Element_To_ID[elementIndex] = ids[i];
+								}
+								if constexpr (ParallelSlots)
+								{
+									positions[IDTraits::IndexOf(ids[i])] = EncodeSlot(ids[i], static_cast<IndexType>(elementIndex));
+								}
+								elementIndex++;
+							}
+						});
+
+					if constexpr (!ParallelSlots)
+					{
+						for (std::size_t i = 0; i < count; i++)
+						{
+							set.StoreSlot<false>(set.m_Element_To_ID[i], static_cast<IndexType>(i));
+						}
+					}
+
+					return count;
+				}
+
+				[[nodiscard]] static bool IsCompatible(const SparseSetFileHeader& header)
+				{
+					return header.Matches<IDType, ElementType, IndexType>(Config::VersionBits) && header.Count <= MaxElements;
+				}
+
+				// Points the sparse index at the first count dense entries, which are expected to be loaded already.
+				[[nodiscard]] bool RebuildSparseIndex(IndexType count)
+				{
+					IDType maxIndex = 0;
+					for (IndexType i = 0; i < count; i++)
+					{
+						maxIndex = std::max(maxIndex, IDTraits::IndexOf(m_Element_To_ID[i]));
+					}
+					if (count != 0)
+					{
+						if (maxIndex > MaxID)
+							return false;
+
+						m_ID_To_Element.Resize(static_cast<std::size_t>(maxIndex) + 1);
+					}
+
+					for (IndexType i = 0; i < count; i++)
+					{
+						const IDType id = m_Element_To_ID[i];
+						if (m_ID_To_Element.Find(IDTraits::IndexOf(id)) != EmptySlot)
+							return false;
+
+						this->StoreSlot<false>(id, i);
+					}
+					return true;
+				}
+
+				void ThrowIfObserved(const char* caller) const
+				{
+					if (m_Observer.Observer)
+						throw std::logic_error(std::string(caller) + ": the set is observed");
+				}
+
+				template<typename Less>
+				void SortIndices(const char* caller, Less&& less)
+				{
+					this->ThrowIfObserved(caller);
+
+					std::vector<IndexType> order(this->Size());
+					std::iota(order.begin(), order.end(), IndexType(0));
+					std::sort(order.begin(), order.end(), less);
+					this->ApplyOrder(order);
+				}
+
+				// Moves the element at order[i] to i by following the permutation cycles, then rewrites the sparse slot of every live element.
+				void ApplyOrder(std::vector<IndexType>& order)
+				{
+					for (IndexType start = 0; start < order.size(); start++)
+					{
+						IndexType current = start;
+						while (order[current] != start)
+						{
+							const IndexType next = order[current];
+							detail::SwapElements(m_Elements[current], m_Elements[next]);
+							std::swap(m_Element_To_ID[current], m_Element_To_ID[next]);
+							m_Changes.OnSwapped(current, next);
+							order[current] = current;
+							current = next;
+						}
+						order[current] = current;
+					}
+
+					for (IndexType i = 0; i < this->DenseSize(); i++)
+					{
+						this->StoreSlot<false>(m_Element_To_ID[i], i);
+					}
+				}
+
+				template<typename Visit>
+				std::size_t PrefetchedLookup(std::span<const IDType> ids, std::size_t distance, Visit&& visit) const
+				{
+					const std::size_t halfDistance = distance / 2;
+					std::size_t numFound = 0;
+					for (std::size_t i = 0; i < ids.size(); i++)
+					{
+						if (i + distance < ids.size())
+						{
+							if (const IndexType* slot = m_ID_To_Element.SlotAddress(IDTraits::IndexOf(ids[i + distance])))
+							{
+								detail::Prefetch(slot);
+							}
+						}
+						if (halfDistance != 0 && i + halfDistance < ids.size())
+						{
+							const IndexType elementIndex = this->FindElementIndex(ids[i + halfDistance]);
+							if (elementIndex < this->DenseSize())
+							{
+								detail::Prefetch(m_Elements.data() + elementIndex);
+							}
+						}
+
+						const IndexType elementIndex = this->FindElementIndex(ids[i]);
+						if (elementIndex != InvalidIndex)
+						{
+							visit(ids[i], elementIndex);
+							numFound++;
+						}
+						else
+						{
+							m_Stats.OnFailedLookup();
+						}
+					}
+					return numFound;
+				}
+
+				template<typename Visit>
+				void VisitDirty(Visit&& visit) const
+				{
+					const std::span<const std::uint64_t> words = m_Changes.DirtyWords();
+					for (std::size_t wordIndex = 0; wordIndex < words.size(); wordIndex++)
+					{
+						for (std::uint64_t word = words[wordIndex]; word != 0; word &= word - 1)
+						{
+							visit(wordIndex * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+						}
+					}
+				}
+
+				template<typename Body, typename Executor>
+				void ParallelChunks(Body&& body, Executor& executor) const
+				{
+					const detail::ParallelChunking chunking(m_Elements.data(), sizeof(ElementType), this->Size(), Config::ParallelMinChunkBytes);
+					if (chunking.NumChunks == 1)
+					{
+						body(std::size_t(0), this->Size());
+					}
+					else if (chunking.NumChunks > 1)
+					{
+						executor(chunking.NumChunks, [&body, &chunking](std::size_t chunk) { body(chunking.Begin(chunk), chunking.End(chunk)); });
+					}
+				}
+
+				void AutoCompact()
+				{
+					static_assert(Config::AutoCompactLoadFactor >= 0.0 && Config::AutoCompactLoadFactor < 1.0, "AutoCompactLoadFactor has to lie in [0, 1)");
+
+					if constexpr (Config::AutoCompactLoadFactor > 0.0)
+					{
+						this->CompactIfNeeded();
+					}
+				}
+
+				// Reallocates the dense arrays to hold capacity elements, drops the spare change tracking and, with GrowOnInsert, compacts the sparse index.
+				void Compact(std::size_t capacity)
+				{
+					ReallocateDense(m_Elements, capacity);
+					ReallocateDense(m_Element_To_ID, capacity);
+					m_Changes.ShrinkToFit(this->Size());
+					if constexpr (Config::GrowOnInsert)
+					{
+						this->CompactSparse();
+					}
+					m_Stats.OnShrinkToFit();
+					m_Stats.OnDenseResize(m_Elements.capacity());
+				}
+
+				// shrink_to_fit to a chosen capacity, a no-op if dense already holds no more than that.
+				template<typename T>
+				static void ReallocateDense(DenseVector<T>& dense, std::size_t capacity)
+				{
+					if (dense.capacity() <= std::max(capacity, dense.size()))
+						return;
+
+					DenseVector<T> reallocated(dense.get_allocator());
+					reallocated.reserve(std::max(capacity, dense.size()));
+					for (T& value : dense)
+					{
+						reallocated.push_back(std::move_if_noexcept(value));
+					}
+					dense = std::move(reallocated);
+				}
+
+				// Size() as a dense index. The dense arrays hold exactly the live elements, so a moved-from set is empty too.
+				[[nodiscard]] IndexType DenseSize() const { return static_cast<IndexType>(m_Element_To_ID.size()); }
+
+				// Exists without reporting a failed lookup, for internal presence tests.
+				[[nodiscard]] bool Contains(IDType id) const
+				{
+					if constexpr (HasOccupancy && !IsVersioned)
+					{
+						return m_Occupancy.Test(id);
+					}
+					else
+					{
+						return this->FindElementIndex(id) != InvalidIndex;
+					}
+				}
+
+				[[nodiscard]] IndexType FindElementIndex(IDType id) const
+				{
+					return DecodeSlot(id, m_ID_To_Element.Find(IDTraits::IndexOf(id)));
+				}
+
+				template<bool Checked>
+				[[nodiscard]] IndexType LoadSlot(IDType id) const
+				{
+					if constexpr (Checked)
+					{
+						return DecodeSlot(id, m_ID_To_Element.At(IDTraits::IndexOf(id)));
+					}
+					else
+					{
+						const IndexType slot = m_ID_To_Element.Slot(IDTraits::IndexOf(id));
+						assert(DecodeSlot(id, slot) != InvalidIndex);
+						return slot & SlotIndexMask;
+					}
+				}
+
+				template<bool Checked>
+				void StoreSlot(IDType id, IndexType elementIndex)
+				{
+					if constexpr (Checked)
+					{
+						m_ID_To_Element.Set(IDTraits::IndexOf(id), EncodeSlot(id, elementIndex));
+					}
+					else
+					{
+						m_ID_To_Element.SetUnchecked(IDTraits::IndexOf(id), EncodeSlot(id, elementIndex));
+					}
+					m_Occupancy.Assign(IDTraits::IndexOf(id), elementIndex != InvalidIndex);
+				}
+
+				template<bool Checked>
+				void GrowFor(IDType index)
+				{
+					const std::size_t previousSize = m_ID_To_Element.Size();
+					detail::PrepareSparseSlot<Config, Checked, MaxID>(m_ID_To_Element, index);
+					if (m_ID_To_Element.Size() != previousSize)
+					{
+						m_Stats.OnSparseResize(m_ID_To_Element.Size());
+					}
+				}
+
+				// Erases the element that occupies the index of id under a different version.
+				void EraseStale(IDType id)
+				{
+					const IndexType slot = m_ID_To_Element.Find(IDTraits::IndexOf(id));
+					if (slot != EmptySlot && DecodeSlot(id, slot) == InvalidIndex)
+					{
+						this->EraseExisting<false>(Access<false>(m_Element_To_ID, slot & SlotIndexMask));
+					}
+				}
+
+				template<bool Checked>
+				void PrepareSlot(IDType id)
+				{
+					this->GrowFor<Checked>(IDTraits::IndexOf(id));
+					if constexpr (IsVersioned)
+					{
+						this->EraseStale(id);
+					}
+				}
+
+				// Every config can run out of dense indices, a full width IndexType too since its maximum is reserved for InvalidIndex.
+				static void CheckCapacity(std::size_t required, const char* message)
+				{
+					detail::CheckCapacity<Config, MaxElements>(required, message);
+				}
+
+				// InsertBatch without the bulk copy, every pair goes through the checks of Insert.
+				std::size_t InsertEach(std::span<const IDType> ids, std::span<const ElementType> elements)
+				{
+					std::size_t numInserted = 0;
+					for (std::size_t i = 0; i < ids.size(); i++)
+					{
+						if (!this->Contains(ids[i]))
+						{
+							if constexpr (IsVersioned)
+							{
+								this->EraseStale(ids[i]);
+							}
+							this->InsertNew(ids[i], elements[i]);
+							numInserted++;
+						}
+					}
+					return numInserted;
+				}
+
+				// Constructs the element in place and returns it, looked up again if the observer may have moved it.
+				template<typename... Args>
+				ElementType& InsertNew(IDType id, Args&&... args)
+				{
+					this->CheckCapacity(this->Size() + 1, "SparseSet::Insert: Size() would exceed MaxElements");
+
+					const std::size_t previousCapacity = m_Elements.capacity();
+					m_Elements.emplace_back(std::forward<Args>(args)...);
+					m_Element_To_ID.push_back(id);
+					if (m_Elements.capacity() != previousCapacity)
+					{
+						m_Stats.OnDenseResize(m_Elements.capacity());
+					}
+					const IndexType elementIndex = static_cast<IndexType>(m_Element_To_ID.size() - 1);
+					this->StoreSlot<false>(id, elementIndex);
+					m_Changes.OnInserted(id, elementIndex);
+					m_Stats.OnInsert(1);
+
+					if (m_Observer.Observer)
+					{
+						m_Observer.Observer->OnInserted(id);
+						return Access<false>(m_Elements, this->LoadSlot<false>(id));
+					}
+					return Access<false>(m_Elements, elementIndex);
+				}
+
+				template<bool Checked>
+				void EraseExisting(IDType id)
+				{
+					if (m_Observer.Observer)
+					{
+						m_Observer.Observer->OnErasing(id);
+					}
+					this->EraseAt<Checked>(this->LoadSlot<Checked>(id));
+				}
+
+				template<bool Checked>
+				void EraseAt(IndexType removedElementIndex)
+				{
+					const IndexType LastIndex = this->DenseSize() - 1;
+					const IDType RemovedID = Access<Checked>(m_Element_To_ID, removedElementIndex);
+					if (removedElementIndex != LastIndex)
+					{
+						// A trivially relocatable element is swapped bytewise with the last one, which pop_back then destroys.
+						if constexpr (IsTriviallyRelocatable<ElementType>::value && !std::is_trivially_copyable_v<ElementType>)
+						{
+							detail::SwapElements(Access<Checked>(m_Elements, removedElementIndex), Access<Checked>(m_Elements, LastIndex));
+						}
+						else
+						{
+							Access<Checked>(m_Elements, removedElementIndex) = std::move(Access<Checked>(m_Elements, LastIndex));
+						}
+						const IDType LastElementID = Access<Checked>(m_Element_To_ID, LastIndex);
+						this->StoreSlot<Checked>(LastElementID, removedElementIndex);
+						Access<Checked>(m_Element_To_ID, removedElementIndex) = LastElementID;
+						m_Changes.OnMoved(LastIndex, removedElementIndex);
+					}
+					m_Elements.pop_back();
+					m_Element_To_ID.pop_back();
+					this->StoreSlot<Checked>(RemovedID, InvalidIndex);
+					m_Changes.OnRemoved(RemovedID, LastIndex);
+					m_Stats.OnErase(1);
+				}
+
+				SparseIndexType m_ID_To_Element;
+				DenseVector<IDType> m_Element_To_ID;
+				DenseVector<ElementType> m_Elements;
+				detail::ObserverSlot<IDType> m_Observer;
+				[[no_unique_address]] detail::ChangeTracker<IDType, AllocatorType, IsTracked> m_Changes;
+				[[no_unique_address]] detail::OccupancyBitset<AllocatorType, HasOccupancy, IsPaged> m_Occupancy;
+				[[no_unique_address]] mutable typename Config::Stats m_Stats;
 		};
+
+		namespace pmr
+		{
+			template<UnsignedInteger IDType, IsMovable ElementType>
+			using SparseSet = DS::SparseSet<IDType, ElementType, PmrSparseSetConfig>;
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,318 @@
+#pragma once
+#include "SparseSet.hpp"
+#include <filesystem>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aZero
+{
+	namespace DS
+	{
+		namespace detail
+		{
+			// Read-only mapping of a whole file, unmapped on destruction.
+			class MappedFile
+			{
+			public:
+				MappedFile() = default;
+
+				explicit MappedFile(const std::filesystem::path& path)
+				{
+#if defined(_WIN32)
+					const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+					if (file == INVALID_HANDLE_VALUE)
+						throw std::runtime_error("MappedFile: can't open " + path.string());
+
+					LARGE_INTEGER size;
+					if (!GetFileSizeEx(file, &size))
+					{
+						CloseHandle(file);
+						throw std::runtime_error("MappedFile: can't read the size of " + path.string());
+					}
+					m_Size = static_cast<std::size_t>(size.QuadPart);
+
+					if (m_Size != 0)
+					{
+						const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+						if (mapping)
+						{
+							m_Data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+							CloseHandle(mapping);
+						}
+					}
+					CloseHandle(file);
+#else
+					const int file = ::open(path.c_str(), O_RDONLY);
+					if (file < 0)
+						throw std::runtime_error("MappedFile: can't open " + path.string());
+
+					struct stat status;
+					if (::fstat(file, &status) != 0)
+					{
+						::close(file);
+						throw std::runtime_error("MappedFile: can't read the size of " + path.string());
+					}
+					m_Size = static_cast<std::size_t>(status.st_size);
+
+					if (m_Size != 0)
+					{
+						void* data = ::mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+						m_Data = data == MAP_FAILED ? nullptr : static_cast<const std::byte*>(data);
+					}
+					::close(file);
+#endif
+					if (m_Size != 0 && !m_Data)
+						throw std::runtime_error("MappedFile: can't map " + path.string());
+				}
+
+				MappedFile(const MappedFile&) = delete;
+				MappedFile& operator=(const MappedFile&) = delete;
+
+				MappedFile(MappedFile&& other) noexcept
+					:m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0)){ }
+
+				MappedFile& operator=(MappedFile&& other) noexcept
+				{
+					if (this != &other)
+					{
+						this->Unmap();
+						m_Data = std::exchange(other.m_Data, nullptr);
+						m_Size = std::exchange(other.m_Size, 0);
+					}
+					return *this;
+				}
+
+				~MappedFile() { this->Unmap(); }
+
+				[[nodiscard]] std::span<const std::byte> Bytes() const { return { m_Data, m_Size }; }
+
+			private:
+				void Unmap()
+				{
+					if (!m_Data)
+						return;
+
+#if defined(_WIN32)
+					UnmapViewOfFile(m_Data);
+#else
+					::munmap(const_cast<std::byte*>(m_Data), m_Size);
+#endif
+					m_Data = nullptr;
+				}
+
+				const std::byte* m_Data = nullptr;
+				std::size_t m_Size = 0;
+			};
+		}
+
+		// Read-only SparseSet over data in the SparseSet::Serialize format, either a mapped file or a caller owned buffer.
+		// IDs and elements are used in place. The sparse slots are used in place too if the data was serialized withSparseIndex, otherwise they are rebuilt once on open.
+		// Opening a mapped index only reads the header. Lookups check the slot against the IDs block, so corrupt slots miss instead of indexing past the dense blocks, and Validate() checks them all.
+		// Lookups behave like those of SparseSet<IDType, ElementType, Config>, including versioned IDs and Config::CheckedAccess.
+		template<UnsignedInteger IDType, IsTriviallyCopyable ElementType, typename ConfigOrIndex = DefaultSparseSetConfig>
+		class SparseSetView
+		{
+			static_assert(alignof(ElementType) <= SparseSetFileHeader::BlockAlignment, "SparseSetView can't align elements beyond the block alignment");
+
+		public:
+			using ConfigType = typename detail::ResolveSparseSetConfig<ConfigOrIndex>::Type;
+			using IndexType = detail::SparseIndexTypeOf<IDType, ConfigType>;
+
+		private:
+			using Config = ConfigType;
+			using IDTraits = VersionedIDTraits<IDType, Config::VersionBits>;
+
+			static constexpr unsigned SlotIndexBits = std::numeric_limits<IndexType>::digits - Config::VersionBits;
+			static constexpr IndexType SlotIndexMask = Config::VersionBits == 0 ? std::numeric_limits<IndexType>::max() : static_cast<IndexType>((IndexType(1) << SlotIndexBits) - 1);
+			static constexpr IndexType EmptySlot = std::numeric_limits<IndexType>::max();
+
+		public:
+			using KeyType = IDType;
+			using ValueType = ElementType;
+
+			static constexpr IndexType InvalidIndex{ std::numeric_limits<IndexType>::max() };
+			static constexpr bool IsChecked = Config::CheckedAccess;
+
+			// Maps the file at path. Throws std::runtime_error if it can't be mapped or doesn't hold a compatible set.
+			explicit SparseSetView(const std::filesystem::path& path)
+				:m_File(path)
+			{
+				this->Open(m_File.Bytes());
+			}
+
+			// Uses bytes in place, they have to stay alive and 64 byte aligned for the lifetime of the view.
+			explicit SparseSetView(std::span<const std::byte> bytes)
+			{
+				this->Open(bytes);
+			}
+
+			SparseSetView(SparseSetView&&) noexcept = default;
+			SparseSetView& operator=(SparseSetView&&) noexcept = default;
+
+			[[nodiscard]] bool Exists(IDType id) const
+			{
+				return this->FindElementIndex(id) != InvalidIndex;
+			}
+
+			[[nodiscard]] const ElementType& Get(IDType id) const
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if constexpr (IsChecked)
+				{
+					if (elementIndex == InvalidIndex)
+						throw std::out_of_range("SparseSetView::Get");
+				}
+				assert(elementIndex != InvalidIndex);
+				return m_Elements[elementIndex];
+			}
+
+			[[nodiscard]] std::optional<std::reference_wrapper<const ElementType>> GetIfExists(IDType id) const
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if (elementIndex == InvalidIndex)
+					return std::nullopt;
+
+				return std::cref(m_Elements[elementIndex]);
+			}
+
+			[[nodiscard]] IndexType GetElementIndex(IDType id) const
+			{
+				const IndexType elementIndex = this->FindElementIndex(id);
+				if constexpr (IsChecked)
+				{
+					if (elementIndex == InvalidIndex)
+						throw std::out_of_range("SparseSetView::GetElementIndex");
+				}
+				return elementIndex;
+			}
+
+			[[nodiscard]] std::size_t Size() const { return m_IDs.size(); }
+
+			[[nodiscard]] std::span<const ElementType> GetElements() const { return m_Elements; }
+
+			[[nodiscard]] std::span<const IDType> GetIDs() const { return m_IDs; }
+
+			[[nodiscard]] const ElementType* begin() const { return m_Elements.data(); }
+			[[nodiscard]] const ElementType* end() const { return m_Elements.data() + m_Elements.size(); }
+
+			// True if the sparse slots are read from the data instead of being rebuilt on open.
+			[[nodiscard]] bool IsSparseIndexMapped() const { return m_OwnedSlots.empty() && !m_Slots.empty(); }
+
+			// True if every slot points at the ID it is looked up with and every ID has its slot. Reads all of the sparse and ID blocks, so it costs what rebuilding the slots would.
+			[[nodiscard]] bool Validate() const
+			{
+				for (std::size_t index = 0; index < m_Slots.size(); index++)
+				{
+					if (m_Slots[index] == EmptySlot)
+						continue;
+
+					const std::size_t elementIndex = m_Slots[index] & SlotIndexMask;
+					if (elementIndex >= m_IDs.size() || IDTraits::IndexOf(m_IDs[elementIndex]) != index || EncodeSlot(m_IDs[elementIndex], static_cast<IndexType>(elementIndex)) != m_Slots[index])
+						return false;
+				}
+				for (std::size_t i = 0; i < m_IDs.size(); i++)
+				{
+					const std::size_t index = IDTraits::IndexOf(m_IDs[i]);
+					if (index >= m_Slots.size() || m_Slots[index] != EncodeSlot(m_IDs[i], static_cast<IndexType>(i)))
+						return false;
+				}
+				return true;
+			}
+
+		private:
+			void Open(std::span<const std::byte> bytes)
+			{
+				SparseSetFileHeader header;
+				if (bytes.size() < sizeof(header))
+					throw std::runtime_error("SparseSetView: the data is too small for a header");
+
+				std::memcpy(&header, bytes.data(), sizeof(header));
+				if (!header.Matches<IDType, ElementType, IndexType>(Config::VersionBits) || bytes.size() < header.End<IDType, ElementType, IndexType>())
+					throw std::runtime_error("SparseSetView: the data doesn't hold a compatible SparseSet");
+
+				if (reinterpret_cast<std::uintptr_t>(bytes.data()) % SparseSetFileHeader::BlockAlignment != 0)
+					throw std::invalid_argument("SparseSetView: the data isn't 64 byte aligned");
+
+				if (header.Count > (Config::VersionBits == 0 ? InvalidIndex : SlotIndexMask))
+					throw std::runtime_error("SparseSetView: the data holds more elements than IndexType can address");
+
+				const std::size_t count = static_cast<std::size_t>(header.Count);
+				m_IDs = { reinterpret_cast<const IDType*>(bytes.data() + header.IDsOffset), count };
+				m_Elements = { reinterpret_cast<const ElementType*>(bytes.data() + header.ElementsOffset), count };
+
+				if (header.NumSparseSlots != 0)
+				{
+					m_Slots = { reinterpret_cast<const IndexType*>(bytes.data() + header.SparseOffset), static_cast<std::size_t>(header.NumSparseSlots) };
+					return;
+				}
+
+				IDType maxIndex = 0;
+				for (const IDType id : m_IDs)
+				{
+					maxIndex = std::max(maxIndex, IDTraits::IndexOf(id));
+				}
+				if (count != 0)
+				{
+					m_OwnedSlots.assign(static_cast<std::size_t>(maxIndex) + 1, EmptySlot);
+				}
+				for (std::size_t i = 0; i < count; i++)
+				{
+					IndexType& slot = m_OwnedSlots[IDTraits::IndexOf(m_IDs[i])];
+					if (slot != EmptySlot)
+						throw std::runtime_error("SparseSetView: the data holds an ID twice");
+
+					slot = EncodeSlot(m_IDs[i], static_cast<IndexType>(i));
+				}
+				m_Slots = m_OwnedSlots;
+			}
+
+			// Same slot encoding as SparseSet, the version sits above the dense index.
+			[[nodiscard]] static IndexType EncodeSlot(IDType id, IndexType elementIndex)
+			{
+				if constexpr (Config::VersionBits != 0)
+				{
+					return static_cast<IndexType>((static_cast<IndexType>(IDTraits::VersionOf(id)) << SlotIndexBits) | elementIndex);
+				}
+				else
+				{
+					return elementIndex;
+				}
+			}
+
+			[[nodiscard]] IndexType FindElementIndex(IDType id) const
+			{
+				const std::size_t index = IDTraits::IndexOf(id);
+				const IndexType slot = index < m_Slots.size() ? m_Slots[index] : EmptySlot;
+				if (slot == EmptySlot)
+					return InvalidIndex;
+
+				// The stored ID carries the version too, and a mapped slot that points elsewhere misses instead of reading past the blocks
+				const IndexType elementIndex = slot & SlotIndexMask;
+				if (elementIndex >= m_IDs.size() || m_IDs[elementIndex] != id)
+					return InvalidIndex;
+
+				return elementIndex;
+			}
+
+			detail::MappedFile m_File;
+			std::vector<IndexType> m_OwnedSlots;
+			std::span<const IndexType> m_Slots;
+			std::span<const IDType> m_IDs;
+			std::span<const ElementType> m_Elements;
+		};
+	}
+}
\ No newline at end of file